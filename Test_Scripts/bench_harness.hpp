@@ -0,0 +1,231 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// Shared timing, statistics and reporting for benchmark_suite.cpp: repeated
+// runs summarized as median / mean / stddev / min / max, CPU pinning, and
+// table, CSV and JSON output. A CSV written by one commit can be passed back as
+// a baseline to flag regressions in the next. The single-purpose benchmarks use
+// do_not_optimize from here too.
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename T>
+inline void do_not_optimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+}
+
+struct Stats {
+    double median = 0, mean = 0, stddev = 0, min = 0, max = 0;
+};
+
+// stddev is the sample standard deviation (n - 1).
+inline Stats summarize(std::vector<double> samples) {
+    Stats s;
+    if (samples.empty()) return s;
+
+    std::sort(samples.begin(), samples.end());
+    size_t n = samples.size();
+    s.min = samples.front();
+    s.max = samples.back();
+    s.median = n % 2 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+
+    double sum = 0;
+    for (double x : samples) sum += x;
+    s.mean = sum / n;
+
+    double sq = 0;
+    for (double x : samples) sq += (x - s.mean) * (x - s.mean);
+    s.stddev = n > 1 ? std::sqrt(sq / (n - 1)) : 0;
+    return s;
+}
+
+// Pins the calling thread to one CPU. Returns false where that is not
+// supported or the CPU is not available to the process.
+inline bool pin_to_cpu(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// setup() runs untimed before every repetition; the first `warmup`
+// repetitions are discarded. Returns nanoseconds per repetition.
+template <typename Setup, typename F>
+Stats measure(size_t reps, size_t warmup, Setup&& setup, F&& f) {
+    std::vector<double> samples;
+    samples.reserve(reps);
+    for (size_t r = 0; r < warmup + reps; ++r) {
+        setup();
+        clobber_memory();
+        auto start = Clock::now();
+        f();
+        clobber_memory();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (r >= warmup) samples.push_back(ns);
+    }
+    return summarize(std::move(samples));
+}
+
+struct Result {
+    std::string group;      // push_back, index_scan, ...
+    std::string container;
+    size_t n = 0;
+    unsigned threads = 1;
+    size_t reps = 0;
+    std::string unit;       // "ns" (time per repetition) or "bytes"
+    Stats stats;
+
+    double per_elem() const {return n ? stats.median / n : 0;}
+    std::string key() const {
+        return group + "|" + container + "|" + std::to_string(n) + "|" + std::to_string(threads);
+    }
+};
+
+struct Context {
+    std::string label;      // e.g. the commit being measured
+    int pinned_cpu = -1;    // -1 when not pinned
+    size_t reps = 0;
+    size_t warmup = 0;
+};
+
+class Reporter {
+    std::vector<Result> results;
+    Context ctx;
+
+    static std::string json_escape(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        return out;
+    }
+
+public:
+    explicit Reporter(Context c) : ctx(std::move(c)) {}
+
+    void add(Result r) {results.push_back(std::move(r));}
+    const std::vector<Result>& all() const {return results;}
+
+    void write_table(std::ostream& os) const {
+        os << std::left << std::setw(20) << "Group" << std::setw(28) << "Container"
+           << std::setw(12) << "N" << std::setw(9) << "Threads" << std::setw(8) << "Unit"
+           << std::setw(14) << "Median" << std::setw(12) << "Stddev%" << std::setw(14) << "Min"
+           << "Per elem" << "\n";
+        os << std::string(128, '-') << "\n";
+        for (const Result& r : results) {
+            double rel = r.stats.median > 0 ? 100.0 * r.stats.stddev / r.stats.median : 0;
+            os << std::left << std::setw(20) << r.group << std::setw(28) << r.container
+               << std::setw(12) << r.n << std::setw(9) << r.threads << std::setw(8) << r.unit
+               << std::fixed << std::setprecision(0) << std::setw(14) << r.stats.median
+               << std::setprecision(1) << std::setw(12) << rel
+               << std::setprecision(0) << std::setw(14) << r.stats.min
+               << std::setprecision(3) << r.per_elem() << "\n";
+        }
+    }
+
+    void write_csv(std::ostream& os) const {
+        os << "group,container,n,threads,reps,unit,median,mean,stddev,min,max,per_elem,label\n";
+        os << std::setprecision(10);
+        for (const Result& r : results) {
+            os << r.group << "," << r.container << "," << r.n << "," << r.threads << "," << r.reps << ","
+               << r.unit << "," << r.stats.median << "," << r.stats.mean << "," << r.stats.stddev << ","
+               << r.stats.min << "," << r.stats.max << "," << r.per_elem() << "," << ctx.label << "\n";
+        }
+    }
+
+    void write_json(std::ostream& os) const {
+        os << std::setprecision(10);
+        os << "{\n  \"context\": {\n"
+           << "    \"label\": \"" << json_escape(ctx.label) << "\",\n"
+           << "    \"timestamp\": " << std::time(nullptr) << ",\n"
+           << "    \"compiler\": \"" << json_escape(__VERSION__) << "\",\n"
+#ifdef NDEBUG
+           << "    \"ndebug\": true,\n"
+#else
+           << "    \"ndebug\": false,\n"
+#endif
+#ifdef CPPX_TIERED_VECTOR_STATS
+           << "    \"instrumented\": true,\n"
+#else
+           << "    \"instrumented\": false,\n"
+#endif
+           << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+           << "    \"pinned_cpu\": " << ctx.pinned_cpu << ",\n"
+           << "    \"reps\": " << ctx.reps << ",\n"
+           << "    \"warmup\": " << ctx.warmup << "\n  },\n"
+           << "  \"results\": [\n";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            os << "    {\"group\": \"" << json_escape(r.group) << "\", \"container\": \"" << json_escape(r.container)
+               << "\", \"n\": " << r.n << ", \"threads\": " << r.threads << ", \"reps\": " << r.reps
+               << ", \"unit\": \"" << r.unit << "\", \"median\": " << r.stats.median
+               << ", \"mean\": " << r.stats.mean << ", \"stddev\": " << r.stats.stddev
+               << ", \"min\": " << r.stats.min << ", \"max\": " << r.stats.max
+               << ", \"per_elem\": " << r.per_elem() << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        os << "  ]\n}\n";
+    }
+
+    // Reads medians from a CSV written by write_csv, keyed like Result::key().
+    static std::map<std::string, double> read_csv(const std::string& path) {
+        std::map<std::string, double> medians;
+        std::ifstream in(path);
+        std::string line;
+        std::getline(in, line); // header
+        while (std::getline(in, line)) {
+            std::vector<std::string> f;
+            std::stringstream ss(line);
+            for (std::string cell; std::getline(ss, cell, ',');) f.push_back(cell);
+            if (f.size() < 7) continue;
+            medians[f[0] + "|" + f[1] + "|" + f[2] + "|" + f[3]] = std::stod(f[6]);
+        }
+        return medians;
+    }
+
+    // Prints every result that also appears in the baseline with its change in
+    // median. Returns how many got worse by more than threshold_pct.
+    size_t compare(const std::map<std::string, double>& baseline, double threshold_pct, std::ostream& os) const {
+        size_t regressions = 0;
+        os << std::left << std::setw(64) << "Case" << std::setw(16) << "Baseline" << std::setw(16) << "Now" << "Change" << "\n";
+        for (const Result& r : results) {
+            auto it = baseline.find(r.key());
+            if (it == baseline.end() || it->second <= 0) continue;
+
+            double change = 100.0 * (r.stats.median - it->second) / it->second;
+            bool worse = change > threshold_pct;
+            regressions += worse;
+            os << std::left << std::setw(64) << r.key() << std::fixed << std::setprecision(0)
+               << std::setw(16) << it->second << std::setw(16) << r.stats.median
+               << std::showpos << std::setprecision(1) << change << "%" << std::noshowpos
+               << (worse ? "  REGRESSION" : "") << "\n";
+        }
+        return regressions;
+    }
+};
+
+}
@@ -0,0 +1,296 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <fstream>
+#include <functional>
+
+#include "../tiered_vector.hpp"
+#include "../concurrent_tiered_vector.hpp"
+#include "bench_harness.hpp"
+using namespace std;
+using namespace cppx;
+
+/*
+
+One suite for push, scan, random access, memory and concurrency, against the
+std::vector and std::deque baselines. Every timing is repeated and reported as
+median / mean / stddev / min / max; the main thread is pinned to one CPU and
+worker threads to it and the CPUs after it.
+
+How to run:
+cmake -S . -B build && cmake --build build --target benchmark_suite
+./build/benchmark_suite                                  # table on stdout
+./build/benchmark_suite --format json --out bench.json   # or --format csv
+./build/benchmark_suite --format csv --out new.csv --compare old.csv --threshold 10
+
+Without CMake:
+g++ -std=c++20 -O3 -pthread benchmark_suite.cpp -o benchmark_suite
+
+Options:
+--sizes 1000000,10000000   element counts
+--reps N / --warmup N      timed / discarded repetitions (default 7 / 1)
+--threads N                threads for the concurrency groups (default: all CPUs)
+--cpu N / --no-pin         CPU for the main thread, or no pinning
+--filter text              only groups or containers containing text
+--label text               stored with the results, e.g. the commit hash
+--compare file.csv         exits with 1 if any median got worse than --threshold %;
+                           the comparison goes to stderr
+--quick                    small sizes and 3 repetitions, as a smoke test
+
+*/
+
+struct Options {
+    vector<size_t> sizes = {1000000, 10000000};
+    size_t reps = 7;
+    size_t warmup = 1;
+    unsigned threads = max(1u, thread::hardware_concurrency());
+    int cpu = 0;
+    bool pin = true;
+    string format = "table";
+    string out;
+    string filter;
+    string label;
+    string compare;
+    double threshold = 10;
+};
+
+vector<size_t> parse_sizes(const string& s) {
+    vector<size_t> sizes;
+    stringstream ss(s);
+    for (string item; getline(ss, item, ',');) sizes.push_back(stoull(item));
+    return sizes;
+}
+
+Options parse_args(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        auto next = [&]() -> string {
+            if (i + 1 >= argc) throw runtime_error("missing value after " + a);
+            return argv[++i];
+        };
+        if (a == "--sizes") o.sizes = parse_sizes(next());
+        else if (a == "--reps") o.reps = stoull(next());
+        else if (a == "--warmup") o.warmup = stoull(next());
+        else if (a == "--threads") o.threads = max(1, stoi(next()));
+        else if (a == "--cpu") o.cpu = stoi(next());
+        else if (a == "--no-pin") o.pin = false;
+        else if (a == "--format") o.format = next();
+        else if (a == "--out") o.out = next();
+        else if (a == "--filter") o.filter = next();
+        else if (a == "--label") o.label = next();
+        else if (a == "--compare") o.compare = next();
+        else if (a == "--threshold") o.threshold = stod(next());
+        else if (a == "--quick") { o.sizes = {100000}; o.reps = 3; }
+        else throw runtime_error("unknown option " + a);
+    }
+    if (o.format != "table" && o.format != "csv" && o.format != "json") throw runtime_error("--format must be table, csv or json");
+    return o;
+}
+
+// Same estimate as memory_benchmark.cpp: 512-byte chunks plus the map.
+size_t deque_bytes(const deque<int>& d) {
+    size_t chunks = (d.size() * sizeof(int) + 511) / 512;
+    return chunks * 512 + chunks * sizeof(int*);
+}
+
+size_t container_bytes(const vector<int>& v) {return v.capacity() * sizeof(int);}
+size_t container_bytes(const deque<int>& d) {return deque_bytes(d);}
+size_t container_bytes(const tiered_vector<int>& tv) {return tv.memory_usage();}
+
+class Suite {
+    const Options& opt;
+    bench::Reporter& report;
+    vector<uint32_t> random_idx;
+
+    bool selected(const string& group, const string& name) const {
+        return opt.filter.empty() || group.find(opt.filter) != string::npos || name.find(opt.filter) != string::npos;
+    }
+
+    void add(const string& group, const string& name, size_t n, unsigned threads, const string& unit, bench::Stats s, size_t reps) {
+        report.add({group, name, n, threads, reps, unit, s});
+        cerr << "  " << group << " / " << name << " n=" << n << " threads=" << threads << " done\n";
+    }
+
+    // Worker k runs on CPU cpu + k; worker 0 shares the main thread's CPU,
+    // which only waits in join().
+    void pin_worker(unsigned t) const {
+        if (opt.pin) bench::pin_to_cpu((opt.cpu + t) % max(1u, thread::hardware_concurrency()));
+    }
+
+public:
+    Suite(const Options& o, bench::Reporter& r) : opt(o), report(r) {}
+
+    template <typename Container>
+    void single_thread(const string& name, size_t n) {
+        if (random_idx.size() != n) {
+            mt19937 rng(42);
+            random_idx.resize(n);
+            for (auto& x : random_idx) x = rng() % n;
+        }
+
+        if (selected("push_back", name)) {
+            Container c;
+            add("push_back", name, n, 1, "ns", bench::measure(opt.reps, opt.warmup,
+                [&] { Container().swap(c); },
+                [&] { for (size_t i = 0; i < n; ++i) c.push_back((int)i); bench::do_not_optimize(c.back()); }), opt.reps);
+        }
+
+        Container c;
+        for (size_t i = 0; i < n; ++i) c.push_back((int)i);
+
+        if (selected("memory", name)) {
+            double bytes = (double)container_bytes(c);
+            add("memory", name, n, 1, "bytes", bench::Stats{bytes, bytes, 0, bytes, bytes}, 1);
+        }
+
+        if (selected("index_scan", name)) {
+            add("index_scan", name, n, 1, "ns", bench::measure(opt.reps, opt.warmup, [] {}, [&] {
+                long long sum = 0;
+                for (size_t i = 0; i < n; ++i) sum += c[i];
+                bench::do_not_optimize(sum);
+            }), opt.reps);
+        }
+
+        if (selected("iter_scan", name)) {
+            add("iter_scan", name, n, 1, "ns", bench::measure(opt.reps, opt.warmup, [] {}, [&] {
+                long long sum = 0;
+                for (int x : c) sum += x;
+                bench::do_not_optimize(sum);
+            }), opt.reps);
+        }
+
+        if (selected("random_access", name)) {
+            add("random_access", name, n, 1, "ns", bench::measure(opt.reps, opt.warmup, [] {}, [&] {
+                long long sum = 0;
+                for (uint32_t i : random_idx) sum += c[i];
+                bench::do_not_optimize(sum);
+            }), opt.reps);
+        }
+
+        if (selected("concurrent_read", name)) {
+            unsigned t = opt.threads;
+            add("concurrent_read", name, n, t, "ns", bench::measure(opt.reps, opt.warmup, [] {}, [&] {
+                vector<thread> pool;
+                for (unsigned k = 0; k < t; ++k) {
+                    pool.emplace_back([&, k] {
+                        pin_worker(k);
+                        long long sum = 0;
+                        for (size_t i = k; i < n; i += t) sum += c[random_idx[i]];
+                        bench::do_not_optimize(sum);
+                    });
+                }
+                for (thread& th : pool) th.join();
+            }), opt.reps);
+        }
+    }
+
+    // Every thread appends n / threads elements through a mutex.
+    template <typename Container>
+    void locked_append(const string& name, size_t n) {
+        if (!selected("concurrent_append", name)) return;
+
+        unsigned t = opt.threads;
+        Container c;
+        mutex mtx;
+        add("concurrent_append", name, n, t, "ns", bench::measure(opt.reps, opt.warmup,
+            [&] { Container().swap(c); },
+            [&] {
+                vector<thread> pool;
+                for (unsigned k = 0; k < t; ++k) {
+                    pool.emplace_back([&, k] {
+                        pin_worker(k);
+                        for (size_t i = k; i < n; i += t) {
+                            lock_guard<mutex> lock(mtx);
+                            c.push_back((int)i);
+                        }
+                    });
+                }
+                for (thread& th : pool) th.join();
+            }), opt.reps);
+    }
+
+    void lock_free_append(size_t n) {
+        const string name = "concurrent_tiered_vector";
+        if (!selected("concurrent_append", name)) return;
+
+        unsigned t = opt.threads;
+        unique_ptr<concurrent_tiered_vector<int>> c;
+        add("concurrent_append", name, n, t, "ns", bench::measure(opt.reps, opt.warmup,
+            [&] { c.reset(); c = make_unique<concurrent_tiered_vector<int>>(); },
+            [&] {
+                vector<thread> pool;
+                for (unsigned k = 0; k < t; ++k) {
+                    pool.emplace_back([&, k] {
+                        pin_worker(k);
+                        for (size_t i = k; i < n; i += t) c->push_back((int)i);
+                    });
+                }
+                for (thread& th : pool) th.join();
+            }), opt.reps);
+    }
+
+    void run() {
+        for (size_t n : opt.sizes) {
+            single_thread<vector<int>>("std::vector", n);
+            single_thread<deque<int>>("std::deque", n);
+            single_thread<tiered_vector<int>>("tiered_vector", n);
+
+            locked_append<vector<int>>("mutex+std::vector", n);
+            locked_append<deque<int>>("mutex+std::deque", n);
+            locked_append<tiered_vector<int>>("mutex+tiered_vector", n);
+            lock_free_append(n);
+        }
+    }
+};
+
+int main(int argc, char** argv) {
+    Options opt;
+    try {
+        opt = parse_args(argc, argv);
+    } catch (const exception& e) {
+        cerr << "benchmark_suite: " << e.what() << "\n";
+        return 2;
+    }
+
+    bench::Context ctx;
+    ctx.label = opt.label;
+    ctx.reps = opt.reps;
+    ctx.warmup = opt.warmup;
+    if (opt.pin) {
+        if (bench::pin_to_cpu(opt.cpu)) ctx.pinned_cpu = opt.cpu;
+        else cerr << "benchmark_suite: could not pin to CPU " << opt.cpu << ", running unpinned\n";
+    }
+
+    bench::Reporter report(ctx);
+    Suite(opt, report).run();
+
+    ofstream file;
+    if (!opt.out.empty()) {
+        file.open(opt.out);
+        if (!file) {
+            cerr << "benchmark_suite: cannot write " << opt.out << "\n";
+            return 2;
+        }
+    }
+    ostream& os = opt.out.empty() ? cout : file;
+    if (opt.format == "json") report.write_json(os);
+    else if (opt.format == "csv") report.write_csv(os);
+    else report.write_table(os);
+
+    if (!opt.compare.empty()) {
+        auto baseline = bench::Reporter::read_csv(opt.compare);
+        if (baseline.empty()) {
+            cerr << "benchmark_suite: no results in " << opt.compare << "\n";
+            return 2;
+        }
+        // stderr, so the report does not end up inside csv/json on stdout.
+        size_t regressions = report.compare(baseline, opt.threshold, cerr);
+        cerr << regressions << " regression(s) above " << opt.threshold << "%\n";
+        if (regressions > 0) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <random>
+#include <bit>
+
+#include "../tiered_fifo.hpp"
+#include "bench_harness.hpp"
+using namespace std;
+using namespace cppx;
+
+/*
+
+How to run:
+g++ -std=c++20 -O3 fifo_benchmark.cpp -o fifo_test
+./fifo_test
+
+*/
+
+// Sliding windows over a stream: keep the last W events, append at the back,
+// drop from the front, and read random positions inside the window.
+const vector<size_t> WINDOWS = {
+    1000,
+    100000,
+    1000000,
+    10000000
+};
+
+const size_t STREAM_OPS = 50'000'000; // steady-state pushes per window size
+const size_t READ_OPS = 10'000'000;   // random reads into the full window
+
+using Clock = std::chrono::high_resolution_clock;
+
+// Counts every allocate() call, so we can see who allocates in steady state.
+size_t g_allocations = 0;
+
+template <typename T>
+struct counting_allocator {
+    using value_type = T;
+
+    counting_allocator() = default;
+    template <typename U>
+    counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(size_t n) {
+        ++g_allocations;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+
+    template <typename U>
+    bool operator==(const counting_allocator<U>&) const { return true; }
+};
+
+// The baseline a careful engineer would write by hand: one power-of-two
+// array allocated up front, head index and size.
+template <typename T>
+class RingBuffer {
+    vector<T, counting_allocator<T>> data;
+    size_t mask;
+    size_t head = 0;
+    size_t sz = 0;
+    size_t max_sz;
+
+public:
+    explicit RingBuffer(size_t max_size) : data(std::bit_ceil(max_size)), mask(std::bit_ceil(max_size) - 1), max_sz(max_size) {}
+
+    void push_back(const T& value) {
+        if (sz == max_sz) pop_front();
+        data[(head + sz++) & mask] = value;
+    }
+
+    void pop_front() {
+        head = (head + 1) & mask;
+        --sz;
+    }
+
+    T& operator[](size_t idx) { return data[(head + idx) & mask]; }
+    size_t size() const { return sz; }
+};
+
+// std::deque has no bound; evict by hand to get the same window semantics.
+template <typename T>
+class DequeWindow {
+    deque<T, counting_allocator<T>> data;
+    size_t max_sz;
+
+public:
+    explicit DequeWindow(size_t max_size) : max_sz(max_size) {}
+
+    void push_back(const T& value) {
+        if (data.size() == max_sz) data.pop_front();
+        data.push_back(value);
+    }
+
+    T& operator[](size_t idx) { return data[idx]; }
+    size_t size() const { return data.size(); }
+};
+
+template <typename T>
+using TieredWindow = tiered_fifo<T, default_block_bits<T>(), counting_allocator<T>>;
+
+struct Result {
+    double mops;         // steady-state pushes (each one evicts) per second, millions
+    size_t allocations;  // allocate() calls during the steady-state phase
+    double read_ns;      // random read into the window
+};
+
+template <typename Window>
+Result test_window(size_t w) {
+    Window c(w);
+    for (size_t i = 0; i < w; ++i) c.push_back((int)i); // warm up: fill the window
+
+    Result r;
+    g_allocations = 0;
+    auto start = Clock::now();
+    for (size_t i = 0; i < STREAM_OPS; ++i) {
+        c.push_back((int)i);
+    }
+    auto end = Clock::now();
+    r.allocations = g_allocations;
+    r.mops = STREAM_OPS / chrono::duration<double>(end - start).count() / 1e6;
+
+    mt19937 rng(42);
+    vector<uint32_t> idx(READ_OPS);
+    for (auto& x : idx) x = rng() % c.size();
+
+    long long sum = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < READ_OPS; ++i) sum += c[idx[i]];
+    end = Clock::now();
+    bench::do_not_optimize(sum);
+    r.read_ns = chrono::duration<double, nano>(end - start).count() / READ_OPS;
+    return r;
+}
+
+void print_header() {
+    cout << left << setw(12) << "Window"
+         << setw(14) << "deque Mops/s" << setw(14) << "ring Mops/s" << setw(14) << "fifo Mops/s"
+         << setw(12) << "deque alloc" << setw(12) << "ring alloc" << setw(12) << "fifo alloc"
+         << setw(12) << "deque rd ns" << setw(12) << "ring rd ns" << setw(12) << "fifo rd ns" << endl;
+    cout << string(128, '-') << endl;
+}
+
+void print_row(size_t w, Result d, Result r, Result f) {
+    cout << left << setw(12) << w << fixed << setprecision(1)
+         << setw(14) << d.mops << setw(14) << r.mops << setw(14) << f.mops
+         << setw(12) << d.allocations << setw(12) << r.allocations << setw(12) << f.allocations
+         << setprecision(2)
+         << setw(12) << d.read_ns << setw(12) << r.read_ns << setw(12) << f.read_ns << endl;
+}
+
+int main() {
+    cout << "\n================================================================================================================================\n";
+    cout << "  SLIDING WINDOW FIFO: " << STREAM_OPS / 1000000 << "M steady-state push+evict, " << READ_OPS / 1000000 << "M random reads\n";
+    cout << "  deque = std::deque, ring = hand-written ring buffer, fifo = tiered_fifo<int>\n";
+    cout << "================================================================================================================================\n";
+    print_header();
+
+    for (size_t w : WINDOWS) {
+        print_row(w, test_window<DequeWindow<int>>(w), test_window<RingBuffer<int>>(w), test_window<TieredWindow<int>>(w));
+    }
+
+    cout << "\n'alloc' counts allocate() calls after the window is full. std::deque keeps\n";
+    cout << "allocating and freeing chunks as the window slides; tiered_fifo recycles\n";
+    cout << "the blocks it drops at the front through its block cache. Its single\n";
+    cout << "allocation is the spare block the back needs before the front frees one.\n";
+    return 0;
+}
@@ -9,6 +9,9 @@
 #include <cmath>
 #include <string>
 #include "../tiered_vector.hpp"
+#include "../tiered_allocators.hpp"
+#include "../compressed_tiered_vector.hpp"
+#include "bench_harness.hpp"
 
 using namespace std;
 using namespace cppx;
@@ -42,6 +45,7 @@ public:
 struct Result {
     double push_ms;
     double seq_ms;  // Sequential Read
+    double iter_ms; // Sequential Read through iterators
     double rnd_ms;  // Random Read
     size_t mem_bytes;
 };
@@ -69,40 +73,54 @@ Result run_test(size_t N) {
 
     // --- TEST 3: SEQUENTIAL SCAN (Hardware Prefetching) ---
     // Simulates: for(size_t i=0; i<N; ++i) sum += c[i];
-    volatile long long sum = 0;
+    long long sum = 0;
     t.reset();
     for(size_t i = 0; i < N; ++i) {
         sum += (*c)[i];
     }
+    bench::do_not_optimize(sum);
     double t_seq = t.ms();
 
+    // --- TEST 3b: ITERATOR SCAN (Segment-Aware Iterators) ---
+    // Simulates: for(auto x : c) sum += x;
+    long long iter_sum = 0;
+    t.reset();
+    for(auto x : *c) {
+        iter_sum += x;
+    }
+    bench::do_not_optimize(iter_sum);
+    double t_iter = t.ms();
+
     // --- TEST 4: RANDOM ACCESS (Cache/TLB Latency) ---
     // Access 10% of elements (capped at 5M ops) randomly
     size_t ops = std::min(N, (size_t)5000000);
     // Linear Congruential Generator for fast, deterministic randomness
     size_t idx = 0;
+    long long rnd_sum = 0;
     t.reset();
     for(size_t i = 0; i < ops; ++i) {
         idx = (idx * 1664525 + 1013904223) % N;
-        sum += (*c)[idx];
+        rnd_sum += (*c)[idx];
     }
+    bench::do_not_optimize(rnd_sum);
     double t_rnd = t.ms();
 
     delete c;
-    return {t_push, t_seq, t_rnd, mem_used};
+    return {t_push, t_seq, t_iter, t_rnd, mem_used};
 }
 
 
 void print_header() {
-    cout << string(115, '-') << endl;
+    cout << string(127, '-') << endl;
     cout << left << setw(12) << "Count" 
          << setw(20) << "Type" 
          << setw(12) << "Push(ms)" 
          << setw(12) << "SeqScan(ms)" 
+         << setw(13) << "IterScan(ms)" 
          << setw(12) << "RndAcc(ms)" 
          << setw(14) << "Total(MB)" 
          << setw(15) << "Bytes/Elem" << endl;
-    cout << string(115, '-') << endl;
+    cout << string(127, '-') << endl;
 }
 
 void print_row(size_t N, string name, Result r) {
@@ -113,12 +131,24 @@ void print_row(size_t N, string name, Result r) {
          << setw(20) << name 
          << setw(12) << fixed << setprecision(1) << r.push_ms 
          << setw(12) << r.seq_ms 
+         << setw(13) << r.iter_ms 
          << setw(12) << r.rnd_ms 
          << setw(14) << setprecision(2) << mb 
          << setw(15) << setprecision(2) << bpe 
          << endl;
 }
 
+// Runs the same workload once per BlockBits value so the block size can be
+// picked per workload (push favours big blocks, RndAcc favours TLB-sized ones).
+template <size_t... Bits>
+void run_block_sweep(size_t N) {
+    print_header();
+    (print_row(N,
+               "tiered<" + to_string(Bits) + "> " + to_string((sizeof(int) << Bits) / 1024) + "KB",
+               run_test<tiered_vector<int, Bits>>(N)), ...);
+    cout << endl;
+}
+
 int main() {
     // SCALING STRATEGY:
     // 1M:   Warmup / L3 Cache Fits
@@ -148,5 +178,55 @@ int main() {
         cout << endl;
     }
 
+    // BLOCK SIZE SWEEP:
+    // 1KB .. 256KB blocks of int, same workload as above.
+    cout << "===================================================================================================================\n";
+    cout << " BLOCK SIZE SWEEP: tiered_vector<int, BlockBits> (default BlockBits = " << default_block_bits<int>() << ")\n";
+    cout << "===================================================================================================================\n";
+
+    for(size_t N : {(size_t)10000000, (size_t)60000000}) {
+        run_block_sweep<8, 9, 10, 11, 12, 13, 14, 15, 16>(N);
+    }
+
+    // ALLOCATION POLICY:
+    // Same workload, blocks from std::allocator, 64-byte aligned, or carved from
+    // 2MB huge pages. RndAcc is where the TLB reach of huge pages shows up
+    // (requires transparent huge pages set to "madvise" or "always").
+    cout << "===================================================================================================================\n";
+    cout << " ALLOCATION POLICY: tiered_vector<int> blocks from std / aligned(64) / huge-page allocators\n";
+    cout << "===================================================================================================================\n";
+
+    constexpr size_t B = default_block_bits<int>();
+    for(size_t N : {(size_t)10000000, (size_t)60000000}) {
+        print_header();
+        print_row(N, "std::allocator", run_test<tiered_vector<int, B>>(N));
+        print_row(N, "aligned_alloc<64>", run_test<tiered_vector<int, B, aligned_allocator<int>>>(N));
+        print_row(N, "huge_page_alloc", run_test<tiered_vector<int, B, huge_page_allocator<int>>>(N));
+        cout << endl;
+    }
+
+    // COMPRESSED BLOCKS:
+    // Same workload on compressed_tiered_vector<int>: full blocks are bit-packed,
+    // scans and random reads decode through an 8-block LRU cache. The values are
+    // 0..N-1, the best case for delta coding; memory_benchmark.cpp Test 5 has
+    // ratios for realistic data.
+    cout << "===================================================================================================================\n";
+    cout << " COMPRESSED BLOCKS: tiered_vector<int> vs compressed_tiered_vector<int>\n";
+    cout << "===================================================================================================================\n";
+
+    for(size_t N : {(size_t)10000000, (size_t)60000000}) {
+        print_header();
+        print_row(N, "tiered_vector", run_test<tiered_vector<int>>(N));
+        print_row(N, "compressed", run_test<compressed_tiered_vector<int>>(N));
+        cout << endl;
+    }
+
+    // Built with -DCPPX_TIERED_VECTOR_STATS: per-container counters of every
+    // tiered_vector above. Comparing the timings with a plain build gives the
+    // cost of the instrumentation.
+#ifdef CPPX_TIERED_VECTOR_STATS
+    tiered_vector_registry::instance().dump(cout);
+#endif
+
     return 0;
 }
@@ -0,0 +1,109 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <random>
+
+#include "../circular_tiered_vector.hpp"
+#include "bench_harness.hpp"
+using namespace std;
+using namespace cppx;
+
+/*
+
+How to run:
+g++ -std=c++20 -O3 insert_erase_benchmark.cpp -o insert_test
+./insert_test
+
+*/
+
+const vector<size_t> SCALES = {
+    1000000,
+    10000000,
+    36500000,
+    73000000 // Target Scale
+};
+
+// Inserts and erases per scale. std::vector moves half the array per call on
+// average, so this is kept small enough for the 73M row to finish.
+const size_t OPS = 1000;
+
+using Clock = std::chrono::high_resolution_clock;
+
+// std::vector / std::deque insert through iterators, circular_tiered_vector by index
+template <typename Container>
+void insert_at(Container& c, size_t idx, int value) {
+    if constexpr (requires { c.insert(idx, value); }) c.insert(idx, value);
+    else c.insert(c.begin() + idx, value);
+}
+
+template <typename Container>
+void erase_at(Container& c, size_t idx) {
+    if constexpr (requires { c.erase(idx); }) c.erase(idx);
+    else c.erase(c.begin() + idx);
+}
+
+struct Result {
+    double insert_us; // per operation
+    double erase_us;
+};
+
+template <typename Container>
+Result test_insert_erase(size_t n) {
+    Container c;
+    for (size_t i = 0; i < n; ++i) c.push_back((int)i);
+
+    // Random positions, drawn outside the timer
+    mt19937 rng(42);
+    vector<size_t> positions(OPS);
+    for (size_t k = 0; k < OPS; ++k) positions[k] = uniform_int_distribution<size_t>(0, n + k)(rng);
+
+    Result r;
+    auto start = Clock::now();
+    for (size_t k = 0; k < OPS; ++k) insert_at(c, positions[k], (int)k);
+    auto end = Clock::now();
+    r.insert_us = chrono::duration<double, micro>(end - start).count() / OPS;
+
+    for (size_t k = 0; k < OPS; ++k) positions[k] = uniform_int_distribution<size_t>(0, n + OPS - k - 1)(rng);
+
+    start = Clock::now();
+    for (size_t k = 0; k < OPS; ++k) erase_at(c, positions[k]);
+    end = Clock::now();
+    r.erase_us = chrono::duration<double, micro>(end - start).count() / OPS;
+
+    bench::do_not_optimize(c[n / 2]);
+    return r;
+}
+
+void print_header() {
+    cout << left << setw(12) << "N"
+         << setw(16) << "vec_ins(us)" << setw(16) << "deq_ins(us)" << setw(16) << "ctv_ins(us)"
+         << setw(16) << "vec_era(us)" << setw(16) << "deq_era(us)" << setw(16) << "ctv_era(us)" << endl;
+    cout << string(108, '-') << endl;
+}
+
+void print_row(size_t n, Result v, Result d, Result c) {
+    cout << left << setw(12) << n << fixed << setprecision(2)
+         << setw(16) << v.insert_us << setw(16) << d.insert_us << setw(16) << c.insert_us
+         << setw(16) << v.erase_us << setw(16) << d.erase_us << setw(16) << c.erase_us << endl;
+}
+
+int main() {
+    cout << "\n============================================================================================================\n";
+    cout << "  RANDOM-POSITION INSERT / ERASE (" << OPS << " ops per scale, microseconds per op)\n";
+    cout << "  ctv = circular_tiered_vector<int>, block_size " << circular_tiered_vector<int>::block_size << "\n";
+    cout << "============================================================================================================\n";
+    print_header();
+
+    for (size_t n : SCALES) {
+        Result v = test_insert_erase<vector<int>>(n);
+        Result d = test_insert_erase<deque<int>>(n);
+        Result c = test_insert_erase<circular_tiered_vector<int>>(n);
+        print_row(n, v, d, c);
+    }
+
+    cout << "\nvector/deque shift O(n) elements per op; circular_tiered_vector shifts one block\n";
+    cout << "plus one element per later block, O(block_size + n/block_size).\n";
+    return 0;
+}
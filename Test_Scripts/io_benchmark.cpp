@@ -0,0 +1,116 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <chrono>
+#include <fcntl.h>
+
+#include "../tiered_io.hpp"
+using namespace std;
+using namespace cppx;
+
+/*
+
+How to run:
+g++ -std=c++20 -O3 io_benchmark.cpp -o io_test
+./io_test [file]      (default file: ./io_benchmark.bin, removed at the end)
+
+*/
+
+const size_t N = 50'000'000; // 200 MB of ints
+
+using Clock = std::chrono::high_resolution_clock;
+
+template <typename F>
+double time_s(F&& f) {
+    auto start = Clock::now();
+    f();
+    return chrono::duration<double>(Clock::now() - start).count();
+}
+
+// The loop this replaces: one ostream::write per element through operator[].
+void save_elementwise(const tiered_vector<int>& tv, const string& path) {
+    ofstream os(path, ios::binary);
+    size_t n = tv.size();
+    os.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    for (size_t i = 0; i < n; ++i) os.write(reinterpret_cast<const char*>(&tv[i]), sizeof(int));
+}
+
+void load_elementwise(tiered_vector<int>& tv, const string& path) {
+    ifstream is(path, ios::binary);
+    size_t n = 0;
+    is.read(reinterpret_cast<char*>(&n), sizeof(n));
+    tv.clear();
+    for (size_t i = 0; i < n; ++i) {
+        int x;
+        is.read(reinterpret_cast<char*>(&x), sizeof(int));
+        tv.push_back(x);
+    }
+}
+
+void save_stream(const tiered_vector<int>& tv, const string& path) {
+    ofstream os(path, ios::binary);
+    save(tv, os);
+}
+
+void load_stream(tiered_vector<int>& tv, const string& path) {
+    ifstream is(path, ios::binary);
+    load(tv, is);
+}
+
+void save_fd(const tiered_vector<int>& tv, const string& path) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    save(tv, fd);
+    ::close(fd);
+}
+
+void load_fd(tiered_vector<int>& tv, const string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    load(tv, fd);
+    ::close(fd);
+}
+
+void print_row(const string& method, double save_s, double load_s) {
+    double mb = N * sizeof(int) / 1e6;
+    cout << left << setw(28) << method << fixed << setprecision(1)
+         << setw(14) << save_s * 1000 << setw(14) << mb / save_s
+         << setw(14) << load_s * 1000 << setw(14) << mb / load_s << endl;
+}
+
+int main(int argc, char** argv) {
+    string path = argc > 1 ? argv[1] : "io_benchmark.bin";
+
+    tiered_vector<int> src;
+    for (size_t i = 0; i < N; ++i) src.push_back((int)i);
+
+    cout << "\n==========================================================================\n";
+    cout << "  CHECKPOINT I/O: " << N / 1000000 << "M ints (" << N * sizeof(int) / 1000000 << " MB), file: " << path << "\n";
+    cout << "==========================================================================\n";
+    cout << left << setw(28) << "Method" << setw(14) << "save (ms)" << setw(14) << "save MB/s"
+         << setw(14) << "load (ms)" << setw(14) << "load MB/s" << endl;
+    cout << "--------------------------------------------------------------------------\n";
+
+    tiered_vector<int> dst;
+    auto check = [&] {
+        if (dst.size() != src.size() || dst[N / 2] != src[N / 2]) cout << "  (ROUND TRIP MISMATCH)\n";
+    };
+
+    double s = time_s([&] { save_elementwise(src, path); });
+    double l = time_s([&] { load_elementwise(dst, path); });
+    print_row("element-wise ostream", s, l);
+    check();
+
+    s = time_s([&] { save_stream(src, path); });
+    l = time_s([&] { load_stream(dst, path); });
+    print_row("save/load(stream)", s, l);
+    check();
+
+    s = time_s([&] { save_fd(src, path); });
+    l = time_s([&] { load_fd(dst, path); });
+    print_row("save/load(fd) writev/readv", s, l);
+    check();
+
+    cout << "\nTimes include the page cache, not fsync: they measure the copy path.\n";
+    ::unlink(path.c_str());
+    return 0;
+}
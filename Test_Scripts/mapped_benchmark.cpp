@@ -0,0 +1,103 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+
+#include "../mapped_tiered_vector.hpp"
+#include "bench_harness.hpp"
+using namespace std;
+using namespace cppx;
+
+/*
+
+How to run:
+g++ -std=c++20 -O3 mapped_benchmark.cpp -o mapped_test
+./mapped_test [file]      (default file: ./mapped_benchmark.bin, removed at the end)
+
+*/
+
+const size_t N = 50'000'000;       // 200 MB of ints
+const size_t READ_OPS = 10'000'000;
+
+using Clock = std::chrono::high_resolution_clock;
+using Mapped = mapped_tiered_vector<int>;
+
+template <typename F>
+double time_ms(F&& f) {
+    auto start = Clock::now();
+    f();
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+template <typename Container>
+long long seq_sum(const Container& c) {
+    long long sum = 0;
+    c.for_each_segment([&](auto seg) { for (int x : seg) sum += x; });
+    return sum;
+}
+
+template <typename Container>
+long long random_sum(const Container& c, const vector<uint32_t>& idx) {
+    long long sum = 0;
+    for (uint32_t i : idx) sum += c[i];
+    return sum;
+}
+
+// heap_ms < 0: the step has no heap counterpart
+void print_row(const string& step, double heap_ms, double mapped_ms) {
+    cout << left << setw(34) << step << fixed << setprecision(1);
+    if (heap_ms < 0) cout << setw(18) << "-";
+    else cout << setw(18) << heap_ms;
+    cout << setw(18) << mapped_ms << endl;
+}
+
+int main(int argc, char** argv) {
+    string path = argc > 1 ? argv[1] : "mapped_benchmark.bin";
+    ::unlink(path.c_str());
+
+    mt19937 rng(42);
+    vector<uint32_t> idx(READ_OPS);
+    for (auto& x : idx) x = rng() % N;
+
+    cout << "\n======================================================================\n";
+    cout << "  FILE-BACKED BLOCKS: tiered_vector<int> vs mapped_tiered_vector<int>\n";
+    cout << "  " << N / 1000000 << "M ints, file: " << path << "\n";
+    cout << "======================================================================\n";
+    cout << left << setw(34) << "Step" << setw(18) << "heap (ms)" << setw(18) << "mapped (ms)" << endl;
+    cout << "----------------------------------------------------------------------\n";
+
+    tiered_vector<int> heap;
+    double heap_build = time_ms([&] { for (size_t i = 0; i < N; ++i) heap.push_back((int)i); });
+
+    double mapped_build, mapped_flush;
+    {
+        Mapped m(path, Mapped::access_pattern::sequential);
+        mapped_build = time_ms([&] { for (size_t i = 0; i < N; ++i) m.push_back((int)i); });
+        mapped_flush = time_ms([&] { m.flush(); });
+    }
+    print_row("push_back build", heap_build, mapped_build);
+    print_row("flush to disk", -1, mapped_flush);
+
+    // Reattach: header read plus one mapping for all blocks, no element I/O
+    Mapped* m = nullptr;
+    double reopen = time_ms([&] { m = new Mapped(path, Mapped::access_pattern::sequential); });
+    print_row("reopen (reattach)", -1, reopen);
+
+    long long a = 0, b = 0;
+    double heap_seq = time_ms([&] { a = seq_sum(heap); });
+    double mapped_seq = time_ms([&] { b = seq_sum(*m); });
+    print_row("sequential scan (MADV_SEQUENTIAL)", heap_seq, mapped_seq);
+    bench::do_not_optimize(a + b);
+
+    m->advise(Mapped::access_pattern::random);
+    double heap_rnd = time_ms([&] { a = random_sum(heap, idx); });
+    double mapped_rnd = time_ms([&] { b = random_sum(*m, idx); });
+    print_row("random reads (MADV_RANDOM)", heap_rnd, mapped_rnd);
+    bench::do_not_optimize(a + b);
+
+    cout << "\nMappings used: " << m->mapping_count() << " (after reopen: one run for all blocks)\n";
+    delete m;
+    ::unlink(path.c_str());
+    return 0;
+}
@@ -4,8 +4,13 @@
 #include <iomanip>
 #include <cmath>
 #include <string>
+#include <random>
+#include <chrono>
+#include <functional>
 
 #include "../tiered_vector.hpp"
+#include "../sparse_tiered_vector.hpp"
+#include "../compressed_tiered_vector.hpp"
 using namespace std;
 using namespace cppx;
 
@@ -30,25 +35,11 @@ size_t get_memory_deque(const deque<int>& d) {
     return (chunks * chunk_size_bytes) + map_overhead;
 }
 
-// 3. Tiered Vector Calculator (Your Logic)
-// Based on the code: 
-// - Spine = array of pointers (block_cap)
-// - Blocks = 1024 ints each
-// - Actual allocated blocks = ceil(size / 1024)
+// 3. Tiered Vector Calculator
+// Exact: memory_usage() counts the allocated blocks, the heap spine and any
+// blocks parked in the container's private block cache.
 size_t get_memory_tiered(const tiered_vector<int>& tv) {
-    // We have to infer internal state since members are private.
-    // Logic: capacity() returns (block_cap * 1024).
-    size_t block_cap = tv.capacity() / 1024;
-    
-    // Logic: blocks allocated. 
-    // In your push_back logic, you allocate a new block every 1024 items.
-    // So allocated blocks is roughly (size + 1023) / 1024.
-    size_t block_sz = (tv.size() + 1023) >> 10;
-    
-    size_t spine_bytes = block_cap * sizeof(int*);
-    size_t data_bytes  = block_sz * 1024 * sizeof(int);
-    
-    return spine_bytes + data_bytes;
+    return tv.memory_usage();
 }
 
 
@@ -145,10 +136,154 @@ int main() {
 
     print_row(target, v, d, tv);
 
+    cout << "After shrink_to_fit() (tiered_vector: " << tv.allocated_blocks() << " blocks, "
+         << tv.spine_capacity() << " spine slots before)...\n";
+    v.shrink_to_fit();
+    d.shrink_to_fit();
+    tv.shrink_to_fit();
+    print_row(target, v, d, tv);
+    cout << "tiered_vector now holds " << tv.allocated_blocks() << " blocks in "
+         << tv.spine_capacity() << " spine slots.\n";
+
+    // --- TEST 3: OSCILLATION (Block Cache Tuning) ---
+    // Swing the size by 50K elements, 200 times. Blocks that fall off the end are
+    // parked in the block cache; anything above its limit goes back to the allocator.
+    // Pick the smallest limit whose allocator traffic is acceptable for the RSS it holds.
+    cout << "\n" << string(90, '-') << "\n";
+    cout << "TEST 3: OSCILLATION (Block Cache Limit vs Allocator Traffic)\n";
+    cout << "1M elements, 200 x (pop 50K, push 50K)\n";
+    cout << string(90, '-') << "\n";
+    cout << left << setw(12) << "Limit" 
+         << setw(15) << "Allocs" 
+         << setw(15) << "Frees" 
+         << setw(15) << "Cache Hits" 
+         << setw(18) << "Peak Cached(MB)" << endl;
+
+    for (size_t limit : {0, 1, 4, 16, 64}) {
+        tiered_vector<int> osc;
+        osc.set_block_cache_limit(limit);
+        for (size_t i = 0; i < 1000000; ++i) osc.push_back(i);
+        osc.get_block_cache()->reset_stats();
+
+        for (int round = 0; round < 200; ++round) {
+            for (int i = 0; i < 50000; ++i) osc.pop_back();
+            for (int i = 0; i < 50000; ++i) osc.push_back(i);
+        }
+
+        block_cache_stats st = osc.cache_stats();
+        cout << left << setw(12) << limit 
+             << setw(15) << st.misses 
+             << setw(15) << st.freed 
+             << setw(15) << st.hits 
+             << setw(18) << fixed << setprecision(2) 
+             << (st.peak_cached * tiered_vector<int>::block_size * sizeof(int)) / (1024.0 * 1024.0) << endl;
+    }
+
+    // --- TEST 4: SPARSE ID SPACE (Dense vs Lazily Materialized Blocks) ---
+    // An ID -> value array over 100M IDs where only some IDs are ever written.
+    // Dense resize(n) allocates every block up front; sparse_tiered_vector
+    // materializes a block on its first write. Random IDs spread writes over
+    // many blocks, clustered IDs (one contiguous range) over few.
+    cout << "\n" << string(90, '-') << "\n";
+    cout << "TEST 4: SPARSE ID SPACE (100M IDs, dense resize vs sparse_tiered_vector)\n";
+    cout << string(90, '-') << "\n";
+    cout << left << setw(22) << "Written IDs"
+         << setw(16) << "Dense(MB)"
+         << setw(16) << "Sparse(MB)"
+         << setw(18) << "Present Blocks"
+         << setw(18) << "Present Scanned" << endl;
+
+    const size_t ID_SPACE = 100000000;
+    tiered_vector<int> dense;
+    dense.resize(ID_SPACE);
+    size_t dense_mem = get_memory_tiered(dense);
+
+    struct SparseCase { const char* name; size_t writes; bool clustered; };
+    const SparseCase cases[] = {
+        {"1K random", 1000, false},
+        {"10K random", 10000, false},
+        {"100K random", 100000, false},
+        {"1M clustered", 1000000, true},
+        {"10M clustered", 10000000, true},
+    };
+
+    mt19937_64 rng(42);
+    for (const SparseCase& c : cases) {
+        sparse_tiered_vector<int> sparse(ID_SPACE);
+        for (size_t k = 0; k < c.writes; ++k) {
+            size_t id = c.clustered ? ID_SPACE / 2 + k : rng() % ID_SPACE;
+            sparse.set(id, 1);
+        }
+
+        size_t scanned = 0;
+        sparse.for_each_present([&](size_t, int) { scanned++; });
+
+        cout << left << setw(22) << c.name
+             << setw(16) << fixed << setprecision(1) << dense_mem / (1024.0 * 1024.0)
+             << setw(16) << sparse.memory_usage() / (1024.0 * 1024.0)
+             << setw(18) << sparse.present_block_count()
+             << setw(18) << scanned << endl;
+    }
+
+    // --- TEST 5: COMPRESSED BLOCKS (Ratio and Scan Throughput) ---
+    // 10M int64 values per dataset. Full blocks are bit-packed with frame-of-
+    // reference or delta coding; scans decode block by block (for_each_segment).
+    cout << "\n" << string(90, '-') << "\n";
+    cout << "TEST 5: COMPRESSED BLOCKS (10M int64, tiered_vector vs compressed_tiered_vector)\n";
+    cout << string(90, '-') << "\n";
+    cout << left << setw(22) << "Dataset"
+         << setw(14) << "Raw(MB)"
+         << setw(16) << "Packed(MB)"
+         << setw(10) << "Ratio"
+         << setw(14) << "Scan(GB/s)"
+         << setw(14) << "Packed(GB/s)" << endl;
+
+    const size_t PACK_N = 10000000;
+    struct PackCase { const char* name; function<int64_t(size_t, mt19937_64&)> gen; };
+    const PackCase packs[] = {
+        {"sequential IDs",     [](size_t i, mt19937_64&) { return (int64_t)i; }},
+        {"ms timestamps",      [](size_t i, mt19937_64& r) { return (int64_t)(1700000000000LL + i * 10 + r() % 5); }},
+        {"counters 0..999",    [](size_t, mt19937_64& r) { return (int64_t)(r() % 1000); }},
+        {"random 32-bit",      [](size_t, mt19937_64& r) { return (int64_t)(uint32_t)r(); }},
+    };
+
+    auto scan_gbs = [&](auto& c, long long& sum) {
+        auto start = chrono::high_resolution_clock::now();
+        c.for_each_segment([&](auto seg) { for (int64_t x : seg) sum += x; });
+        double s = chrono::duration<double>(chrono::high_resolution_clock::now() - start).count();
+        return PACK_N * sizeof(int64_t) / s / 1e9;
+    };
+
+    for (const PackCase& c : packs) {
+        mt19937_64 r(42);
+        tiered_vector<int64_t> plain;
+        compressed_tiered_vector<int64_t> packed;
+        for (size_t i = 0; i < PACK_N; ++i) {
+            int64_t x = c.gen(i, r);
+            plain.push_back(x);
+            packed.push_back(x);
+        }
+
+        long long a = 0, b = 0;
+        double plain_gbs = scan_gbs(plain, a);
+        double packed_gbs = scan_gbs(packed, b);
+
+        cout << left << setw(22) << c.name
+             << setw(14) << fixed << setprecision(1) << packed.raw_bytes() / (1024.0 * 1024.0)
+             << setw(16) << packed.memory_usage() / (1024.0 * 1024.0)
+             << setw(10) << setprecision(2) << packed.compression_ratio()
+             << setw(14) << plain_gbs
+             << setw(14) << packed_gbs
+             << (a == b ? "" : "  (CHECKSUM MISMATCH)") << endl;
+    }
+
     cout << "\n[ANALYSIS]\n";
     size_t v_mem = get_memory_vector(v);
     size_t tv_mem = get_memory_tiered(tv);
-    
+    cout << "After the shrink test, tiered_vector holds " << v.size() << " ints in "
+         << fixed << setprecision(1) << tv_mem / (1024.0 * 1024.0) << " MB, std::vector in "
+         << v_mem / (1024.0 * 1024.0) << " MB.\n";
+
 
     return 0;
 }
\ No newline at end of file
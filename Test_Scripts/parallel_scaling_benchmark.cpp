@@ -0,0 +1,110 @@
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <iomanip>
+#include <thread>
+#include "../tiered_parallel.hpp"
+#include "bench_harness.hpp"
+
+using namespace std;
+using namespace cppx;
+
+/*
+
+How to run:
+g++ -std=c++20 -O3 -pthread parallel_scaling_benchmark.cpp -o parallel_test
+./parallel_test
+
+*/
+
+const size_t N = 20'000'000;
+
+using Clock = chrono::high_resolution_clock;
+
+template <typename F>
+double time_ms(F&& f) {
+    auto start = Clock::now();
+    f();
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+// Deliberately uneven work: the first quarter of the indices costs ~64x more.
+// With a static split, the thread owning that quarter finishes last; work
+// stealing lets the others take over its remaining blocks.
+inline int skewed_work(int x) {
+    unsigned h = (unsigned)x;
+    int rounds = (x < (int)(N / 4)) ? 64 : 1;
+    for (int r = 0; r < rounds; ++r) {
+        h ^= h >> 13;
+        h *= 0x5bd1e995u;
+        h ^= h >> 15;
+    }
+    return (int)h;
+}
+
+struct Row {
+    double fill;
+    double generate;
+    double transform;
+    double reduce;
+    double uneven;
+};
+
+Row run_scaling_test(size_t threads) {
+    parallel::thread_pool pool(threads);
+    tiered_vector<int> tv;
+    tv.resize(N);
+
+    Row r;
+    r.fill = time_ms([&] { parallel::fill(tv, 7, pool); });
+    r.generate = time_ms([&] { parallel::generate(tv, [](size_t i) { return (int)i; }, pool); });
+    r.transform = time_ms([&] { parallel::transform(tv, [](int x) { return x * 3 + 1; }, pool); });
+
+    long long sum = 0;
+    r.reduce = time_ms([&] { sum = parallel::reduce(tv, 0LL, plus<>{}, pool); });
+    bench::do_not_optimize(sum);
+
+    parallel::generate(tv, [](size_t i) { return (int)i; }, pool);
+    r.uneven = time_ms([&] { parallel::for_each(tv, [](int& x) { x = skewed_work(x); }, pool); });
+    bench::do_not_optimize(tv[N - 1]);
+
+    return r;
+}
+
+int main() {
+    size_t hw = max<size_t>(1, thread::hardware_concurrency());
+
+    vector<size_t> thread_counts;
+    for (size_t t = 1; t < hw; t <<= 1) thread_counts.push_back(t);
+    thread_counts.push_back(hw);
+
+    cout << "\n==========================================================================================\n";
+    cout << "  PARALLEL BLOCK ALGORITHMS: SCALING 1 -> " << hw << " THREADS (" << N / 1000000 << "M ints)\n";
+    cout << "==========================================================================================\n";
+    cout << left << setw(10) << "Threads"
+         << setw(12) << "fill(ms)"
+         << setw(14) << "generate(ms)"
+         << setw(15) << "transform(ms)"
+         << setw(12) << "reduce(ms)"
+         << setw(14) << "uneven(ms)"
+         << setw(12) << "Speedup" << endl;
+    cout << "------------------------------------------------------------------------------------------\n";
+
+    double base = 0;
+    for (size_t t : thread_counts) {
+        Row r = run_scaling_test(t);
+        if (t == 1) base = r.uneven;
+
+        cout << left << setw(10) << t
+             << setw(12) << fixed << setprecision(1) << r.fill
+             << setw(14) << r.generate
+             << setw(15) << r.transform
+             << setw(12) << r.reduce
+             << setw(14) << r.uneven
+             << setw(12) << setprecision(2) << (base / r.uneven) << endl;
+    }
+
+    cout << "\nSpeedup is measured on the uneven for_each, which relies on work stealing.\n";
+    cout << "==========================================================================================\n";
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+
+#include "../cow_tiered_vector.hpp"
+#include "bench_harness.hpp"
+using namespace std;
+using namespace cppx;
+
+/*
+
+How to run:
+g++ -std=c++20 -O3 snapshot_benchmark.cpp -o snapshot_test
+./snapshot_test
+
+*/
+
+const size_t N = 100'000'000;   // 400 MB of ints
+const size_t WRITES = 1'000'000; // random writes after taking the copy
+
+using Clock = std::chrono::high_resolution_clock;
+
+template <typename F>
+double time_ms(F&& f) {
+    auto start = Clock::now();
+    f();
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+template <typename Container>
+long long const_scan(const Container& c) {
+    long long sum = 0;
+    c.for_each_segment([&](auto seg) { for (int x : seg) sum += x; });
+    return sum;
+}
+
+struct Result {
+    double copy_ms;
+    double scan_ms;       // const scan of the copy
+    double first_writes;  // random writes to the original right after the copy
+    double more_writes;   // the same number again, blocks already private
+};
+
+// The same steps for a deep copy (tiered_vector) and a snapshot (cow_tiered_vector).
+template <typename Container, typename Copy>
+Result run(Container& c, const vector<uint32_t>& idx, Copy make_copy) {
+    Result r;
+    Container* copy = nullptr;
+    r.copy_ms = time_ms([&] { copy = new Container(make_copy(c)); });
+
+    long long sum = 0;
+    r.scan_ms = time_ms([&] { sum = const_scan(*copy); });
+    bench::do_not_optimize(sum);
+
+    r.first_writes = time_ms([&] { for (uint32_t i : idx) c[i] += 1; });
+    r.more_writes = time_ms([&] { for (uint32_t i : idx) c[i] += 1; });
+    bench::do_not_optimize(c[idx[0]]);
+
+    delete copy;
+    return r;
+}
+
+void print_row(const string& name, const Result& r) {
+    cout << left << setw(28) << name << fixed << setprecision(2)
+         << setw(14) << r.copy_ms << setw(14) << r.scan_ms
+         << setw(18) << r.first_writes << setw(18) << r.more_writes << endl;
+}
+
+int main() {
+    mt19937 rng(42);
+    vector<uint32_t> idx(WRITES);
+    for (auto& x : idx) x = rng() % N;
+
+    cout << "\n==========================================================================================\n";
+    cout << "  SNAPSHOTS: " << N / 1000000 << "M ints, deep copy vs copy-on-write, then " << WRITES / 1000 << "K random writes\n";
+    cout << "==========================================================================================\n";
+    cout << left << setw(28) << "Copy" << setw(14) << "copy (ms)" << setw(14) << "scan (ms)"
+         << setw(18) << "1st writes (ms)" << setw(18) << "2nd writes (ms)" << endl;
+    cout << "------------------------------------------------------------------------------------------\n";
+
+    {
+        tiered_vector<int> tv;
+        for (size_t i = 0; i < N; ++i) tv.push_back((int)i);
+        print_row("tiered_vector copy", run(tv, idx, [](const tiered_vector<int>& c) { return c; }));
+    }
+    {
+        cow_tiered_vector<int> cow;
+        cow.reserve(N);
+        for (size_t i = 0; i < N; ++i) cow.push_back((int)i);
+        print_row("cow_tiered_vector snapshot", run(cow, idx, [](const cow_tiered_vector<int>& c) { return c.snapshot(); }));
+    }
+
+    cout << "\n1st writes on the snapshot row include duplicating each block on its first write.\n";
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+
+#include "../tiered_vector.hpp"
+#include "../tiered_soa.hpp"
+#include "bench_harness.hpp"
+using namespace std;
+using namespace cppx;
+
+/*
+
+How to run:
+g++ -std=c++20 -O3 soa_benchmark.cpp -o soa_test
+./soa_test
+
+*/
+
+using Clock = std::chrono::high_resolution_clock;
+
+template <typename F>
+double time_ms(F&& f) {
+    auto start = Clock::now();
+    f();
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+// 32-byte record; the scans below read one or two of its fields.
+struct Trade {
+    int64_t id;
+    double price;
+    int32_t qty;
+    int32_t venue;
+    int64_t timestamp;
+};
+
+using TradeColumns = tiered_soa<int64_t, double, int32_t, int32_t, int64_t>;
+enum { ID, PRICE, QTY, VENUE, TIMESTAMP };
+
+struct Result {
+    double push_ms;
+    double one_col_ms;   // sum(price)
+    double two_col_ms;   // sum(price * qty)
+    double all_cols_ms;  // every field of every row
+};
+
+Trade make_trade(size_t i, mt19937& rng) {
+    return Trade{(int64_t)i, (double)(rng() % 10000) / 100.0, (int32_t)(rng() % 1000), (int32_t)(rng() % 16), (int64_t)(1700000000000LL + i)};
+}
+
+Result run_aos(size_t n) {
+    Result r;
+    mt19937 rng(42);
+    tiered_vector<Trade> tv;
+    r.push_ms = time_ms([&] { for (size_t i = 0; i < n; ++i) tv.push_back(make_trade(i, rng)); });
+
+    double sum = 0;
+    r.one_col_ms = time_ms([&] {
+        tv.for_each_segment([&](auto seg) { for (const Trade& t : seg) sum += t.price; });
+    });
+    bench::do_not_optimize(sum);
+
+    sum = 0;
+    r.two_col_ms = time_ms([&] {
+        tv.for_each_segment([&](auto seg) { for (const Trade& t : seg) sum += t.price * t.qty; });
+    });
+    bench::do_not_optimize(sum);
+
+    int64_t acc = 0;
+    r.all_cols_ms = time_ms([&] {
+        for (const Trade& t : tv) acc += t.id + (int64_t)t.price + t.qty + t.venue + t.timestamp;
+    });
+    bench::do_not_optimize(acc);
+    return r;
+}
+
+Result run_soa(size_t n) {
+    Result r;
+    mt19937 rng(42);
+    TradeColumns soa;
+    r.push_ms = time_ms([&] {
+        for (size_t i = 0; i < n; ++i) {
+            Trade t = make_trade(i, rng);
+            soa.emplace_back(t.id, t.price, t.qty, t.venue, t.timestamp);
+        }
+    });
+
+    double sum = 0;
+    r.one_col_ms = time_ms([&] {
+        soa.for_each_segment<PRICE>([&](auto seg) { for (double p : seg) sum += p; });
+    });
+    bench::do_not_optimize(sum);
+
+    // Two columns: walk the matching segments side by side.
+    sum = 0;
+    r.two_col_ms = time_ms([&] {
+        for (size_t b = 0; b < soa.segment_count(); ++b) {
+            auto price = soa.segment<PRICE>(b);
+            auto qty = soa.segment<QTY>(b);
+            for (size_t i = 0; i < price.size(); ++i) sum += price[i] * qty[i];
+        }
+    });
+    bench::do_not_optimize(sum);
+
+    int64_t acc = 0;
+    r.all_cols_ms = time_ms([&] {
+        for (auto [id, price, qty, venue, ts] : soa) acc += id + (int64_t)price + qty + venue + ts;
+    });
+    bench::do_not_optimize(acc);
+    return r;
+}
+
+void print_row(size_t n, const string& name, const Result& r) {
+    cout << left << setw(12) << n << setw(28) << name << fixed << setprecision(2)
+         << setw(12) << r.push_ms << setw(14) << r.one_col_ms
+         << setw(14) << r.two_col_ms << setw(14) << r.all_cols_ms << endl;
+}
+
+int main() {
+    // The AoS and SoA containers are built one after the other, so the 73M
+    // case peaks at ~2.3 GB rather than twice that.
+    vector<size_t> scales = {10000000, 36500000, 73000000};
+
+    cout << "\n==========================================================================================================\n";
+    cout << "  COLUMNAR SCANS: " << sizeof(Trade) << "-byte records, tiered_vector<Trade> (AoS) vs tiered_soa (SoA)\n";
+    cout << "==========================================================================================================\n";
+    cout << left << setw(12) << "Count" << setw(28) << "Layout" << setw(12) << "Push(ms)"
+         << setw(14) << "1 col(ms)" << setw(14) << "2 cols(ms)" << setw(14) << "zip all(ms)" << endl;
+    cout << "----------------------------------------------------------------------------------------------------------\n";
+
+    for (size_t n : scales) {
+        print_row(n, "tiered_vector<Trade>", run_aos(n));
+        print_row(n, "tiered_soa<5 columns>", run_soa(n));
+        cout << "----------------------------------------------------------------------------------------------------------\n";
+    }
+
+    cout << "\n1 col reads price only, 2 cols reads price and qty, zip all visits every field through the iterator.\n";
+    return 0;
+}
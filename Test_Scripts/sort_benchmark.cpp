@@ -0,0 +1,92 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+#include "../tiered_vector.hpp"
+#include "../tiered_parallel.hpp"
+using namespace std;
+using namespace cppx;
+
+/*
+
+How to run:
+g++ -std=c++20 -O3 -pthread sort_benchmark.cpp -o sort_test
+./sort_test
+
+*/
+
+using Clock = std::chrono::high_resolution_clock;
+
+template <typename F>
+double time_ms(F&& f) {
+    auto start = Clock::now();
+    f();
+    return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+// A comparator that is not std::less keeps cppx::sort on the block sort + merge
+// path, so the comparison sort and the radix path are measured separately.
+struct Ascending {
+    bool operator()(int a, int b) const {return a < b;}
+};
+
+template <typename Container>
+bool is_sorted_container(const Container& c) {
+    for (size_t i = 1; i < c.size(); ++i) if (c[i] < c[i - 1]) return false;
+    return true;
+}
+
+void print_row(size_t n, const string& name, double ms, bool ok) {
+    cout << left << setw(12) << n << setw(40) << name << fixed << setprecision(1)
+         << setw(14) << ms << (ok ? "" : "  (NOT SORTED)") << endl;
+}
+
+int main() {
+    vector<size_t> scales = {10000000, 36500000, 73000000};
+
+    cout << "\n==========================================================================\n";
+    cout << "  SORT: random ints, " << parallel::default_pool().size() << " thread(s)\n";
+    cout << "==========================================================================\n";
+    cout << left << setw(12) << "Count" << setw(40) << "Sort" << setw(14) << "Time(ms)" << endl;
+    cout << "--------------------------------------------------------------------------\n";
+
+    for (size_t n : scales) {
+        vector<int> data(n);
+        mt19937 rng(42);
+        for (int& x : data) x = (int)rng();
+
+        {
+            vector<int> v = data;
+            double ms = time_ms([&] { std::sort(v.begin(), v.end()); });
+            print_row(n, "std::sort(std::vector)", ms, is_sorted_container(v));
+        }
+
+        tiered_vector<int> tv;
+        tv.append(data.data(), n);
+        {
+            tiered_vector<int> t = tv;
+            double ms = time_ms([&] { std::sort(t.begin(), t.end()); });
+            print_row(n, "std::sort(tiered_vector iterators)", ms, is_sorted_container(t));
+        }
+        {
+            tiered_vector<int> t = tv;
+            double ms = time_ms([&] { cppx::sort(t, Ascending{}); });
+            print_row(n, "cppx::sort (block sort + merge)", ms, is_sorted_container(t));
+        }
+        {
+            tiered_vector<int> t = tv;
+            double ms = time_ms([&] { cppx::stable_sort(t, Ascending{}); });
+            print_row(n, "cppx::stable_sort (block sort + merge)", ms, is_sorted_container(t));
+        }
+        {
+            tiered_vector<int> t = tv;
+            double ms = time_ms([&] { cppx::sort(t); });
+            print_row(n, "cppx::sort (radix path)", ms, is_sorted_container(t));
+        }
+        cout << "--------------------------------------------------------------------------\n";
+    }
+    return 0;
+}
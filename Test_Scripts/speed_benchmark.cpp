@@ -6,8 +6,10 @@
 #include <random>
 #include <numeric>
 #include <algorithm>
+#include <memory_resource>
 
 #include "../tiered_vector.hpp"
+#include "bench_harness.hpp"
 using namespace std;
 using namespace cppx; 
 
@@ -22,12 +24,6 @@ const vector<size_t> SCALES = {
 
 using Clock = std::chrono::high_resolution_clock;
 
-// Prevents compiler from deleting loops that don't produce visible output
-template <typename T>
-void do_not_optimize(T const& value) {
-    asm volatile("" : : "r,m"(value) : "memory");
-}
-
 // Helper to generate random indices (Outside the timer)
 vector<size_t> generate_random_indices(size_t n) {
     vector<size_t> indices(n);
@@ -52,7 +48,7 @@ double test_unreserved(size_t n) {
         c.push_back((int)i);
     }
     auto end = Clock::now();
-    do_not_optimize(c.size());
+    bench::do_not_optimize(c.size());
     return std::chrono::duration<double>(end - start).count();
 }
 
@@ -69,7 +65,7 @@ double test_reserved_write(size_t n) {
         c[i] = (int)i;
     }
     auto end = Clock::now();
-    do_not_optimize(c[n-1]);
+    bench::do_not_optimize(c[n-1]);
     return std::chrono::duration<double>(end - start).count();
 }
 
@@ -81,15 +77,15 @@ double test_sequential_read(size_t n) {
     // Fill with data first (untimed)
     for(size_t i=0; i<n; ++i) c[i] = (int)i;
 
-    volatile long long sum = 0;
+    long long sum = 0;
     
     auto start = Clock::now();
     for (size_t i = 0; i < n; ++i) {
         sum += c[i];
     }
+    bench::do_not_optimize(sum);
     auto end = Clock::now();
-    
-    do_not_optimize(sum);
+
     return std::chrono::duration<double>(end - start).count();
 }
 
@@ -101,7 +97,7 @@ double test_random_read(size_t n, const vector<size_t>& indices) {
     // Fill with data first (untimed)
     for(size_t i=0; i<n; ++i) c[i] = (int)i;
 
-    volatile long long sum = 0;
+    long long sum = 0;
 
     auto start = Clock::now();
     // Use the pre-calculated random indices to test pure access time
@@ -109,12 +105,136 @@ double test_random_read(size_t n, const vector<size_t>& indices) {
     for (size_t idx : indices) {
         sum += c[idx];
     }
+    bench::do_not_optimize(sum);
+    auto end = Clock::now();
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+
+// 5. ALLOCATOR SOURCE (Growth + Teardown)
+// Same push_back loop, but blocks and spine come from different places.
+// Teardown is inside the timer: that is where an arena releases everything at once.
+double test_alloc_global(size_t n) {
+    auto start = Clock::now();
+    {
+        tiered_vector<int> c;
+        for (size_t i = 0; i < n; ++i) {
+            c.push_back((int)i);
+        }
+        bench::do_not_optimize(c.size());
+    }
+    auto end = Clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+template <typename Resource>
+double test_alloc_pmr(size_t n) {
+    auto start = Clock::now();
+    {
+        Resource resource;
+        cppx::pmr::tiered_vector<int> c(&resource);
+        for (size_t i = 0; i < n; ++i) {
+            c.push_back((int)i);
+        }
+        bench::do_not_optimize(c.size());
+    }
+    auto end = Clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+
+// 6. SEGMENTED READ (Vectorizable Scan)
+// tiered_vector walks its blocks as contiguous spans, which the compiler can
+// vectorize; the others use iterators.
+template <typename Container>
+double test_segment_read(size_t n) {
+    Container c;
+    c.resize(n);
+    for(size_t i=0; i<n; ++i) c[i] = (int)i;
+
+    long long sum = 0;
+
+    auto start = Clock::now();
+    if constexpr (is_same_v<Container, tiered_vector<int>>) {
+        c.for_each_segment([&sum](span<const int> seg) {
+            for (int x : seg) sum += x;
+        });
+    } else {
+        for (int x : c) sum += x;
+    }
     auto end = Clock::now();
 
-    do_not_optimize(sum);
+    bench::do_not_optimize(sum);
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// 7. BULK APPEND (Batch Ingest)
+// The source is one contiguous buffer, loaded in batches of up to 1M elements.
+// vector::insert vs a push_back loop vs tiered_vector::append (block memcpy).
+const size_t BULK_BATCH = 1000000;
+
+double test_bulk_vector_insert(const vector<int>& src) {
+    auto start = Clock::now();
+    vector<int> c;
+    for (size_t i = 0; i < src.size(); i += BULK_BATCH) {
+        size_t n = std::min(BULK_BATCH, src.size() - i);
+        c.insert(c.end(), src.data() + i, src.data() + i + n);
+    }
+    auto end = Clock::now();
+    bench::do_not_optimize(c.size());
     return std::chrono::duration<double>(end - start).count();
 }
 
+double test_bulk_tiered_push(const vector<int>& src) {
+    auto start = Clock::now();
+    tiered_vector<int> c;
+    for (size_t i = 0; i < src.size(); ++i) {
+        c.push_back(src[i]);
+    }
+    auto end = Clock::now();
+    bench::do_not_optimize(c.size());
+    return std::chrono::duration<double>(end - start).count();
+}
+
+double test_bulk_tiered_append(const vector<int>& src) {
+    auto start = Clock::now();
+    tiered_vector<int> c;
+    for (size_t i = 0; i < src.size(); i += BULK_BATCH) {
+        c.append(src.data() + i, std::min(BULK_BATCH, src.size() - i));
+    }
+    auto end = Clock::now();
+    bench::do_not_optimize(c.size());
+    return std::chrono::duration<double>(end - start).count();
+}
+
+// 8. FRONT GROWTH (Work Queue)
+// push_front n items, then scan them, which is what a deque-based work queue does.
+// std::vector has no O(1) push_front, so only deque and tiered_vector compete.
+struct FrontResult {
+    double push;
+    double scan;
+};
+
+template <typename Container>
+FrontResult test_front_growth(size_t n) {
+    FrontResult r;
+    Container c;
+    auto start = Clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        c.push_front((int)i);
+    }
+    auto end = Clock::now();
+    r.push = std::chrono::duration<double>(end - start).count();
+
+    long long sum = 0;
+    start = Clock::now();
+    for (int x : c) sum += x;
+    end = Clock::now();
+    bench::do_not_optimize(sum);
+    r.scan = std::chrono::duration<double>(end - start).count();
+    return r;
+}
 
 void print_header(string mode) {
     cout << "\n========================================================================================\n";
@@ -144,6 +264,74 @@ void print_row(size_t n, double v, double d, double t) {
          << setw(15) << winner << endl;
 }
 
+void print_alloc_header() {
+    cout << "\n========================================================================================\n";
+    cout << " BENCHMARK: TieredVec ALLOCATOR (push_back + destroy)\n";
+    cout << "========================================================================================\n";
+    cout << left << setw(15) << "N Elements" 
+         << setw(18) << "global new" 
+         << setw(18) << "pmr pool" 
+         << setw(18) << "pmr monotonic" 
+         << setw(15) << "Winner" << endl;
+    cout << "----------------------------------------------------------------------------------------\n";
+}
+
+void print_alloc_row(size_t n, double g, double p, double m) {
+    string winner = "Global";
+    if (p < g && p <= m) winner = "Pool";
+    else if (m < g && m < p) winner = "Monotonic";
+
+    cout << left << setw(15) << n 
+         << setw(18) << fixed << setprecision(5) << g 
+         << setw(18) << fixed << setprecision(5) << p 
+         << setw(18) << fixed << setprecision(5) << m 
+         << setw(15) << winner << endl;
+}
+
+void print_bulk_header() {
+    cout << "\n========================================================================================\n";
+    cout << " BENCHMARK: BULK APPEND (1M-element batches from a contiguous buffer)\n";
+    cout << "========================================================================================\n";
+    cout << left << setw(15) << "N Elements" 
+         << setw(18) << "vector::insert" 
+         << setw(18) << "Tiered push_back" 
+         << setw(18) << "Tiered append" 
+         << setw(15) << "Winner" << endl;
+    cout << "----------------------------------------------------------------------------------------\n";
+}
+
+void print_bulk_row(size_t n, double v, double p, double a) {
+    string winner = "Vector";
+    if (p < v && p <= a) winner = "Push";
+    else if (a < v && a < p) winner = "Append";
+
+    cout << left << setw(15) << n 
+         << setw(18) << fixed << setprecision(5) << v 
+         << setw(18) << fixed << setprecision(5) << p 
+         << setw(18) << fixed << setprecision(5) << a 
+         << setw(15) << winner << endl;
+}
+
+void print_front_header() {
+    cout << "\n========================================================================================\n";
+    cout << " BENCHMARK: FRONT GROWTH (push_front, then scan)\n";
+    cout << "========================================================================================\n";
+    cout << left << setw(15) << "N Elements" 
+         << setw(18) << "deque push" 
+         << setw(18) << "Tiered push" 
+         << setw(18) << "deque scan" 
+         << setw(18) << "Tiered scan" << endl;
+    cout << "----------------------------------------------------------------------------------------\n";
+}
+
+void print_front_row(size_t n, FrontResult d, FrontResult t) {
+    cout << left << setw(15) << n 
+         << setw(18) << fixed << setprecision(5) << d.push 
+         << setw(18) << fixed << setprecision(5) << t.push 
+         << setw(18) << fixed << setprecision(5) << d.scan 
+         << setw(18) << fixed << setprecision(5) << t.scan << endl;
+}
+
 int main() {
     cout << "Starting Comprehensive Benchmark...\n";
     cout << "Scaling to " << SCALES.back() << " items.\n";
@@ -192,6 +380,42 @@ int main() {
             test_random_read<tiered_vector<int>>(n, indices));
     }
 
+    // 5. ALLOCATOR SOURCE
+    print_alloc_header();
+    for (size_t n : SCALES) {
+        print_alloc_row(n,
+            test_alloc_global(n),
+            test_alloc_pmr<std::pmr::unsynchronized_pool_resource>(n),
+            test_alloc_pmr<std::pmr::monotonic_buffer_resource>(n));
+    }
+
+    // 6. SEGMENTED READ
+    print_header("SEGMENTED READ (for_each_segment vs iterators)");
+    for (size_t n : SCALES) {
+        print_row(n, 
+            test_segment_read<vector<int>>(n),
+            test_segment_read<deque<int>>(n),
+            test_segment_read<tiered_vector<int>>(n));
+    }
+
+    // 7. BULK APPEND
+    print_bulk_header();
+    for (size_t n : SCALES) {
+        vector<int> src(n);
+        iota(src.begin(), src.end(), 0);
+
+        print_bulk_row(n,
+            test_bulk_vector_insert(src),
+            test_bulk_tiered_push(src),
+            test_bulk_tiered_append(src));
+    }
+
+    // 8. FRONT GROWTH
+    print_front_header();
+    for (size_t n : SCALES) {
+        print_front_row(n, test_front_growth<deque<int>>(n), test_front_growth<tiered_vector<int>>(n));
+    }
+
     cout << "\nBenchmark Complete.\n";
     return 0;
 }
\ No newline at end of file
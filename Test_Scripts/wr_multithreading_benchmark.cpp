@@ -10,6 +10,9 @@
 #include <iomanip>
 #include <omp.h>
 #include "../tiered_vector.hpp"
+#include "../concurrent_tiered_vector.hpp"
+#include "../segmented_lock_tiered_vector.hpp"
+#include "../epoch_tiered_vector.hpp"
 
 using namespace std;
 using namespace cppx;
@@ -17,7 +20,7 @@ using namespace cppx;
 /*
 
 How to run:
-g++ -O3 -fopenmp wr_multithreading_benchmark.cpp -o lock_test
+g++ -std=c++20 -O3 -fopenmp wr_multithreading_benchmark.cpp -o lock_test
 ./lock_test
 
 */
@@ -40,46 +43,104 @@ public:
         std::unique_lock lock(mtx); 
         data[idx] = val;
     }
+
+    T read(size_t idx) {
+        std::shared_lock lock(mtx);
+        return data[idx];
+    }
 };
 
-// Since blocks never move, we only lock the specific block we touch.
+// Since blocks never move, segmented_lock_tiered_vector (library type) only
+// locks the block we touch; there is no container-wide lock on access.
+// Readers of the same block share its reader/writer lock.
 template <typename T>
-class SegmentedLockWrapper {
+using SegmentedLockWrapper = segmented_lock_tiered_vector<T>;
+
+// Multi-producer append: a plain tiered_vector needs a global lock around
+// push_back, because sz and the spine are shared by every appender.
+template <typename T>
+class LockedAppendWrapper {
     tiered_vector<T> data;
-    // We create a "Stripe" of mutexes. 
-    // Ideally 1 mutex per block, or a fixed pool (e.g., 64 mutexes) to save RAM.
-    // For this demo, let's map blocks to 128 mutexes.
-    static const size_t NUM_LOCKS = 128; 
-    std::mutex locks[NUM_LOCKS];
+    std::mutex mtx;
 
 public:
-    void resize(size_t n) {
-        // Resize touches the spine, so we might need a global lock 
-        // strictly for the resizing moment, but NOT for data access.
-        // For this test, we assume size is pre-allocated to focus on ACCESS speed.
-        data.resize(n);
+    void push_back(T val) {
+        std::lock_guard<std::mutex> lock(mtx);
+        data.push_back(val);
     }
 
-    // Thread A writing Block 0 runs PARALLEL to Thread B writing Block 1
-    void write(size_t idx, T val) {
-        // 1. Find which block this index belongs to
-        size_t block_idx = idx >> 10;
-        
-        // 2. Map block to a mutex (Stripe)
-        size_t lock_idx = block_idx % NUM_LOCKS;
-
-        // 3. Lock ONLY that segment
-        std::lock_guard<std::mutex> lock(locks[lock_idx]);
-        data[idx] = val;
+    size_t size() const { return data.size(); }
+};
+
+// concurrent_tiered_vector reserves the slot with one fetch_add and
+// constructs in place, so appenders only meet when a new block is published.
+template <typename T>
+class ConcurrentAppendWrapper {
+    concurrent_tiered_vector<T> data;
+
+public:
+    void push_back(T val) { data.push_back(val); }
+
+    size_t size() const { return data.size(); }
+};
+
+// Single writer appending while readers index: with a plain tiered_vector the
+// spine can be reallocated under a reader, so every access and every append
+// takes the lock. (A shared_mutex starves the writer here: readers always hold it.)
+template <typename T>
+class LockedStreamWrapper {
+    tiered_vector<T> data;
+    mutable std::mutex mtx;
+
+public:
+    void push_back(T val) {
+        std::lock_guard<std::mutex> lock(mtx);
+        data.push_back(val);
+    }
+
+    // Readers need no per-thread state.
+    int make_reader() const { return 0; }
+
+    long long read_batch(int, mt19937& rng, int count) const {
+        long long sum = 0;
+        for (int k = 0; k < count; ++k) {
+            std::lock_guard<std::mutex> lock(mtx);
+            size_t n = data.size();
+            if (n > 0) sum += data[rng() % n];
+        }
+        return sum;
     }
 };
 
+// epoch_tiered_vector retires old spines instead of freeing them, so readers
+// only pin once per batch and never wait for the writer.
+template <typename T>
+class EpochAppendWrapper {
+    epoch_tiered_vector<T> data;
+
+public:
+    void push_back(T val) { data.push_back(val); }
+
+    // Each reader thread claims its own epoch slot.
+    auto make_reader() const { return data.reader(); }
+
+    template <typename Reader>
+    long long read_batch(const Reader& reader, mt19937& rng, int count) const {
+        long long sum = 0;
+        auto pin = reader.pin();
+        size_t n = data.size();
+        if (n == 0) return 0;
+        for (int k = 0; k < count; ++k) sum += data[rng() % n];
+        return sum;
+    }
+};
 
 const size_t N = 10'000'000;
-const int NUM_OPS = 5'000'000'0; // 50 Million random writes
+const int NUM_OPS = 5'000'000'0; // 50 Million random operations
 
+// read_percent of the operations are reads, the rest writes.
 template <typename ContainerWrapper>
-void run_concurrency_test(string name) {
+void run_concurrency_test(string name, int read_percent) {
     ContainerWrapper container;
     container.resize(N); // Pre-fill
 
@@ -89,12 +150,24 @@ void run_concurrency_test(string name) {
     uniform_int_distribution<size_t> dist(0, N - 1);
     for(auto &x : indices) x = dist(rng);
 
+    // Decide read vs write up front too, so every container sees the same mix
+    vector<char> is_read(NUM_OPS);
+    uniform_int_distribution<int> pct(0, 99);
+    for(auto &r : is_read) r = pct(rng) < read_percent;
+    atomic<long long> checksum{0};
+
     auto start = chrono::high_resolution_clock::now();
 
     // The Parallel Workload
-    #pragma omp parallel for
-    for (int i = 0; i < NUM_OPS; ++i) {
-        container.write(indices[i], i);
+    #pragma omp parallel
+    {
+        long long local = 0;
+        #pragma omp for
+        for (int i = 0; i < NUM_OPS; ++i) {
+            if (is_read[i]) local += container.read(indices[i]);
+            else container.write(indices[i], i);
+        }
+        checksum += local;
     }
 
     auto end = chrono::high_resolution_clock::now();
@@ -106,18 +179,108 @@ void run_concurrency_test(string name) {
          << " | " << setprecision(1) << (ops_sec / 1e6) << " M ops/sec" << endl;
 }
 
+const int NUM_APPENDS = 20'000'000;
+
+template <typename ContainerWrapper>
+void run_append_test(string name) {
+    ContainerWrapper container;
+
+    auto start = chrono::high_resolution_clock::now();
+
+    #pragma omp parallel for
+    for (int i = 0; i < NUM_APPENDS; ++i) {
+        container.push_back(i);
+    }
+
+    auto end = chrono::high_resolution_clock::now();
+    double duration = chrono::duration<double>(end - start).count();
+    double ops_sec = NUM_APPENDS / duration;
+
+    cout << left << setw(25) << name
+         << " | Time: " << fixed << setprecision(3) << duration << "s"
+         << " | " << setprecision(1) << (ops_sec / 1e6) << " M ops/sec"
+         << (container.size() == (size_t)NUM_APPENDS ? "" : "  (SIZE MISMATCH)") << endl;
+}
+
+const int NUM_STREAM_APPENDS = 20'000'000;
+const int READ_BATCH = 64;
+
+// One writer appends NUM_STREAM_APPENDS elements while the other threads keep
+// reading random indices below the current size until it finishes.
+template <typename ContainerWrapper>
+void run_single_writer_test(string name, size_t reader_threads) {
+    ContainerWrapper container;
+    atomic<bool> done{false};
+    atomic<long long> reads{0};
+    atomic<long long> checksum{0};
+
+    vector<thread> readers;
+    for (size_t t = 0; t < reader_threads; ++t) {
+        readers.emplace_back([&, t] {
+            mt19937 rng(42 + t);
+            auto reader = container.make_reader();
+            long long local = 0, count = 0;
+            while (!done.load(memory_order_relaxed)) {
+                local += container.read_batch(reader, rng, READ_BATCH);
+                count += READ_BATCH;
+            }
+            reads += count;
+            checksum += local;
+        });
+    }
+
+    auto start = chrono::high_resolution_clock::now();
+    for (int i = 0; i < NUM_STREAM_APPENDS; ++i) container.push_back(i);
+    auto end = chrono::high_resolution_clock::now();
+    done = true;
+    for (thread& t : readers) t.join();
+
+    double duration = chrono::duration<double>(end - start).count();
+    cout << left << setw(25) << name
+         << " | Writer: " << fixed << setprecision(3) << duration << "s"
+         << " | " << setprecision(1) << (NUM_STREAM_APPENDS / duration / 1e6) << " M appends/sec"
+         << " | Readers: " << (reads.load() / duration / 1e6) << " M reads/sec" << endl;
+}
+
 int main() {
     size_t threads = 16;
     omp_set_num_threads(threads); // Force high contention
 
+    struct Workload { const char* name; int read_percent; };
+    const Workload workloads[] = {
+        {"50M Random Writes", 0},
+        {"Mixed 50% Reads / 50% Writes", 50},
+        {"Read-Heavy 90% Reads / 10% Writes", 90},
+    };
+
+    for (const Workload& w : workloads) {
+        cout << "\n=============================================================\n";
+        cout << "  LOCK GRANULARITY SHOWDOWN (16 Threads, " << w.name << ")\n";
+        cout << "=============================================================\n";
+        cout << "Scenario: 16 threads hitting random indices, " << w.read_percent << "% reads.\n";
+        cout << "Expectation: Vector locks globally. Tiered locks locally.\n\n";
+
+        run_concurrency_test<GlobalLockWrapper<int>>("Global Lock (Vector)", w.read_percent);
+        run_concurrency_test<SegmentedLockWrapper<int>>("Segmented Lock (Tiered)", w.read_percent);
+    }
+
+    cout << "\n=============================================================\n";
+    cout << "  MULTI-PRODUCER APPEND (16 Threads, 20M push_back)\n";
+    cout << "=============================================================\n";
+    cout << "Scenario: 16 threads appending into one shared container.\n";
+    cout << "Expectation: the lock serializes appends; atomic reservation doesn't.\n\n";
+
+    run_append_test<LockedAppendWrapper<int>>("Global Lock (Tiered)");
+    run_append_test<ConcurrentAppendWrapper<int>>("Concurrent (Tiered)");
+
     cout << "\n=============================================================\n";
-    cout << "  LOCK GRANULARITY SHOWDOWN (16 Threads, 50M Random Writes)\n";
+    cout << "  SINGLE WRITER + READERS (1 writer, " << threads - 1 << " readers, 20M push_back)\n";
     cout << "=============================================================\n";
-    cout << "Scenario: 16 threads trying to write to random indices.\n";
-    cout << "Expectation: Vector locks globally. Tiered locks locally.\n\n";
+    cout << "Scenario: one thread appends while the rest read random indices.\n";
+    cout << "Expectation: the lock makes readers and the writer take turns; epoch readers never wait.\n\n";
 
-    run_concurrency_test<GlobalLockWrapper<int>>("Global Lock (Vector)");
-    run_concurrency_test<SegmentedLockWrapper<int>>("Segmented Lock (Tiered)");
+    run_single_writer_test<LockedStreamWrapper<int>>("Global Lock (Tiered)", threads - 1);
+    run_single_writer_test<EpochAppendWrapper<int>>("Epoch Spine (Tiered)", threads - 1);
 
     cout << "\n=============================================================\n";
     return 0;
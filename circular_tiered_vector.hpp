@@ -0,0 +1,314 @@
+#pragma once
+#include "tiered_vector.hpp"
+
+namespace cppx {
+
+// Ordered sequence with O(1) indexing and O(block_size + n/block_size) insert
+// and erase anywhere (Goodrich & Kloss, "Tiered Vectors").
+//
+// Each block is a circular buffer with its own head offset, and every block but
+// the last is full. Inserting at i shifts the tail of i's block by one, then
+// hands one element per later block forward: the last element of block k is
+// pushed onto the front of block k+1 by moving that block's head back one slot.
+// Erase does the reverse. No element outside i's block is shifted.
+//
+// With n elements the cost is minimised around block_size ~ sqrt(n), so pick
+// BlockBits for the sizes you expect; the default favours scans like
+// tiered_vector's. Blocks are rotated, so unlike tiered_vector they are not
+// exposed as contiguous spans.
+template <typename T, size_t BlockBits = default_block_bits<T>(), typename Allocator = std::allocator<T>>
+class circular_tiered_vector{
+    static_assert(BlockBits > 0 && BlockBits < 32, "BlockBits must be in [1, 31]");
+
+    public:
+        static constexpr size_t block_bits = BlockBits;
+        static constexpr size_t block_size = size_t(1) << BlockBits;
+        static constexpr size_t block_mask = block_size - 1;
+
+        template <bool is_const>
+        class CircularVectorIterator{
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using difference_type   = std::ptrdiff_t;
+                using value_type        = T;
+                using pointer           = std::conditional_t<is_const, const T*, T*>;
+                using reference         = std::conditional_t<is_const, const T&, T&>;
+                using parent_type       = std::conditional_t<is_const, const circular_tiered_vector*, circular_tiered_vector*>;
+
+            private:
+                template <bool> friend class CircularVectorIterator;
+                friend class circular_tiered_vector;
+
+                parent_type parent;
+                size_t idx;
+
+            public:
+                CircularVectorIterator() : parent(nullptr), idx(0) {}
+                CircularVectorIterator(parent_type v, size_t i) : parent(v), idx(i) {}
+
+                template <bool other_const, typename = std::enable_if_t<is_const && !other_const>>
+                CircularVectorIterator(const CircularVectorIterator<other_const>& other) : parent(other.parent), idx(other.idx) {}
+
+                reference operator*() const {return (*parent)[idx];}
+                pointer operator->() const {return &(*parent)[idx];}
+
+                CircularVectorIterator& operator++(){++idx; return *this;}
+                CircularVectorIterator operator++(int){CircularVectorIterator tmp = *this; ++idx; return tmp;}
+                CircularVectorIterator& operator--(){--idx; return *this;}
+                CircularVectorIterator operator--(int){CircularVectorIterator tmp = *this; --idx; return tmp;}
+
+                CircularVectorIterator& operator+=(difference_type incr){idx += incr; return *this;}
+                CircularVectorIterator& operator-=(difference_type incr){idx -= incr; return *this;}
+
+                friend CircularVectorIterator operator+(CircularVectorIterator it, difference_type incr){return it += incr;}
+                friend CircularVectorIterator operator+(difference_type incr, CircularVectorIterator it){return it += incr;}
+                friend CircularVectorIterator operator-(CircularVectorIterator it, difference_type incr){return it -= incr;}
+
+                friend difference_type operator-(const CircularVectorIterator& a, const CircularVectorIterator& b){return a.idx - b.idx;}
+
+                friend bool operator==(const CircularVectorIterator& a, const CircularVectorIterator& b){return a.idx == b.idx;}
+                friend bool operator!=(const CircularVectorIterator& a, const CircularVectorIterator& b){return a.idx != b.idx;}
+                friend bool operator<(const CircularVectorIterator& a, const CircularVectorIterator& b){return a.idx < b.idx;}
+                friend bool operator<=(const CircularVectorIterator& a, const CircularVectorIterator& b){return a.idx <= b.idx;}
+                friend bool operator>(const CircularVectorIterator& a, const CircularVectorIterator& b){return a.idx > b.idx;}
+                friend bool operator>=(const CircularVectorIterator& a, const CircularVectorIterator& b){return a.idx >= b.idx;}
+                reference operator[](difference_type incr) const {return (*parent)[idx + incr];}
+        };
+
+    private:
+        struct ring{
+            T* data;
+            size_t head;
+        };
+
+        using alloc_traits   = std::allocator_traits<Allocator>;
+        using ring_allocator = typename alloc_traits::template rebind_alloc<ring>;
+
+        static_assert(is_same_v<typename alloc_traits::pointer, T*>, "fancy pointers are not supported");
+
+        std::vector<ring, ring_allocator> rings;
+        size_t sz;
+        [[no_unique_address]] Allocator alloc;
+
+        T* slot(size_t b, size_t off) const {return rings[b].data + ((rings[b].head + off)&block_mask);}
+
+        // Blocks before the last are always full.
+        size_t count(size_t b) const {return b + 1 < rings.size() ? block_size : sz - (b<<BlockBits);}
+
+        void relocate(T* dst, T* src){
+            alloc_traits::construct(alloc, dst, move(*src));
+            alloc_traits::destroy(alloc, src);
+        }
+
+        void add_block(){
+            T* blk = alloc_traits::allocate(alloc, block_size);
+            try{
+                rings.push_back(ring{blk, 0});
+            }
+            catch(...){
+                alloc_traits::deallocate(alloc, blk, block_size);
+                throw;
+            }
+        }
+
+        // One empty block is kept at the back so a single insert/erase pair at a
+        // block boundary doesn't allocate and free every time.
+        void trim_back(){
+            while(!rings.empty() && sz < ((rings.size() - 1)<<BlockBits)){
+                alloc_traits::deallocate(alloc, rings.back().data, block_size);
+                rings.pop_back();
+            }
+        }
+
+        // Opens a hole at idx and returns it; the hole holds no object.
+        T* open_gap(size_t idx){
+            if(sz == (rings.size()<<BlockBits)) add_block();
+
+            size_t b = idx>>BlockBits;
+            size_t off = idx&block_mask;
+
+            // Ripple one element forward per block, from the back, so every
+            // block from b on has room for what it receives.
+            for(size_t k = rings.size() - 1; k > b; --k){
+                rings[k].head = (rings[k].head - 1)&block_mask;
+                relocate(rings[k].data + rings[k].head, slot(k - 1, block_mask));
+            }
+
+            // Slot c is empty; the others are live, so the first step constructs
+            // and the rest assign, leaving a moved-from object at off.
+            size_t c = (b + 1 < rings.size()) ? block_mask : sz - (b<<BlockBits);
+            for(size_t j = c; j > off; --j){
+                if(j == c) alloc_traits::construct(alloc, slot(b, j), move(*slot(b, j - 1)));
+                else *slot(b, j) = move(*slot(b, j - 1));
+            }
+            if(off < c) alloc_traits::destroy(alloc, slot(b, off));
+            return slot(b, off);
+        }
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using iterator = CircularVectorIterator<false>;
+        using const_iterator = CircularVectorIterator<true>;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        circular_tiered_vector() : circular_tiered_vector(Allocator()) {}
+
+        explicit circular_tiered_vector(const Allocator& a) : rings(ring_allocator(a)), sz(0), alloc(a) {}
+
+        circular_tiered_vector(initializer_list<T> value, const Allocator& a = Allocator()) : circular_tiered_vector(a){
+            for(const T& x : value) emplace_back(x);
+        }
+
+        template <std::input_iterator InputIt>
+        circular_tiered_vector(InputIt first, InputIt last, const Allocator& a = Allocator()) : circular_tiered_vector(a){
+            for(; first != last; ++first) emplace_back(*first);
+        }
+
+        circular_tiered_vector(const circular_tiered_vector& value) :
+            circular_tiered_vector(alloc_traits::select_on_container_copy_construction(value.alloc))
+        {
+            for(size_t i = 0; i < value.sz; ++i) emplace_back(value[i]);
+        }
+
+        circular_tiered_vector(circular_tiered_vector && value) noexcept :
+            rings(move(value.rings)), sz(value.sz), alloc(value.alloc)
+        {
+            value.rings.clear();
+            value.sz = 0;
+        }
+
+        ~circular_tiered_vector(){
+            clear();
+        }
+
+        void swap(circular_tiered_vector& other) noexcept {
+            using std::swap;
+            swap(rings, other.rings);
+            swap(sz, other.sz);
+            if constexpr (alloc_traits::propagate_on_container_swap::value) swap(alloc, other.alloc);
+        }
+
+        circular_tiered_vector& operator= (const circular_tiered_vector& value){
+            if(this != &value){
+                circular_tiered_vector tmp(value);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        circular_tiered_vector& operator= (circular_tiered_vector && value) noexcept {
+            if(this != &value){
+                clear();
+                swap(value);
+            }
+            return *this;
+        }
+
+        allocator_type get_allocator() const {return alloc;}
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args){
+            if(sz == (rings.size()<<BlockBits)) add_block();
+            T* p = slot(sz>>BlockBits, sz&block_mask);
+            alloc_traits::construct(alloc, p, std::forward<Args>(args)...);
+            sz++;
+            return *p;
+        }
+
+        void push_back(const T& value){
+            emplace_back(value);
+        }
+
+        void push_back(T&& value){
+            emplace_back(move(value));
+        }
+
+        void pop_back(){
+            if(sz == 0) return;
+
+            sz--;
+            alloc_traits::destroy(alloc, slot(sz>>BlockBits, sz&block_mask));
+            trim_back();
+        }
+
+        // Inserts before position idx (idx == size() appends) and returns the new
+        // element. The value is built first, so args may alias the container.
+        template <typename... Args>
+        T& emplace(size_t idx, Args&&... args){
+            T value(std::forward<Args>(args)...);
+            T* p = open_gap(idx);
+            alloc_traits::construct(alloc, p, move(value));
+            sz++;
+            return *p;
+        }
+
+        T& insert(size_t idx, const T& value){return emplace(idx, value);}
+        T& insert(size_t idx, T&& value){return emplace(idx, move(value));}
+
+        iterator insert(const_iterator pos, const T& value){
+            emplace(pos.idx, value);
+            return iterator(this, pos.idx);
+        }
+
+        iterator insert(const_iterator pos, T&& value){
+            emplace(pos.idx, move(value));
+            return iterator(this, pos.idx);
+        }
+
+        void erase(size_t idx){
+            size_t b = idx>>BlockBits;
+            size_t c = count(b);
+
+            for(size_t j = idx&block_mask; j + 1 < c; ++j) *slot(b, j) = move(*slot(b, j + 1));
+            alloc_traits::destroy(alloc, slot(b, c - 1));
+
+            // Pull the front of every later block back into the hole behind it.
+            for(size_t k = b + 1; k < rings.size() && (k<<BlockBits) < sz; ++k){
+                relocate(slot(k - 1, block_mask), rings[k].data + rings[k].head);
+                rings[k].head = (rings[k].head + 1)&block_mask;
+            }
+
+            sz--;
+            trim_back();
+        }
+
+        iterator erase(const_iterator pos){
+            erase(pos.idx);
+            return iterator(this, pos.idx);
+        }
+
+        void clear(){
+            if constexpr (!is_trivially_destructible_v<T>){
+                for(size_t i = 0; i < sz; ++i) alloc_traits::destroy(alloc, slot(i>>BlockBits, i&block_mask));
+            }
+            for(ring& r : rings) alloc_traits::deallocate(alloc, r.data, block_size);
+            rings.clear();
+            sz = 0;
+        }
+
+        T& operator[](size_t idx){return *slot(idx>>BlockBits, idx&block_mask);}
+        const T& operator[](size_t idx) const {return *slot(idx>>BlockBits, idx&block_mask);}
+
+        T& front(){return (*this)[0];}
+        const T& front() const {return (*this)[0];}
+        T& back(){return (*this)[sz - 1];}
+        const T& back() const {return (*this)[sz - 1];}
+
+        iterator begin() {return iterator(this, 0);}
+        iterator end() {return iterator(this, sz);}
+        const_iterator begin() const {return const_iterator(this, 0);}
+        const_iterator end() const {return const_iterator(this, sz);}
+        const_iterator cbegin() const {return begin();}
+        const_iterator cend() const {return end();}
+        reverse_iterator rbegin() {return reverse_iterator(end());}
+        reverse_iterator rend() {return reverse_iterator(begin());}
+        const_reverse_iterator rbegin() const {return const_reverse_iterator(end());}
+        const_reverse_iterator rend() const {return const_reverse_iterator(begin());}
+
+        size_t size() const {return sz;}
+        bool empty() const {return sz == 0;}
+};
+
+}
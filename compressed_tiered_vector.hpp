@@ -0,0 +1,340 @@
+#pragma once
+#include "tiered_vector.hpp"
+
+namespace cppx {
+
+// Tiered vector of integers, grown by push_back, that compresses every block
+// once it is full ("sealed"). Meant for write-once, read-rarely data such as
+// IDs, counters and timestamps; set() can still correct single elements.
+//
+// A sealed block is bit-packed with one of two codecs, whichever is smaller:
+//   frame_of_reference: value - min, packed at the width of (max - min)
+//   delta:              v[i] - v[i-1], frame-of-reference packed, so sorted
+//                       or slowly changing data (timestamps) packs to a few bits
+// Only the last, still filling block is kept as plain integers.
+//
+// operator[] returns by value. Frame-of-reference elements (and delta blocks
+// of width 0) are unpacked directly in O(1). A delta element depends on every
+// delta before it, so its block is decoded whole into a small LRU cache of hot
+// blocks (cache_blocks() of them, default 8) and runs of reads within it
+// decode it once. for_each_segment decodes block by block into one scratch
+// buffer and leaves the cache alone, which is the fast way to scan. The cache
+// makes reads mutate internal state: const reads are not thread-safe.
+template <typename T, size_t BlockBits = default_block_bits<T>()>
+class compressed_tiered_vector{
+    static_assert(BlockBits > 0 && BlockBits < 32, "BlockBits must be in [1, 31]");
+    static_assert(is_integral_v<T> && !is_same_v<T, bool>, "compressed_tiered_vector packs integers");
+
+    public:
+        static constexpr size_t block_bits = BlockBits;
+        static constexpr size_t block_size = size_t(1) << BlockBits;
+        static constexpr size_t block_mask = block_size - 1;
+
+        enum class codec : uint8_t {frame_of_reference, delta};
+
+        struct cache_stats_type{
+            size_t hits;
+            size_t misses;
+        };
+
+        // Read-only iterator; dereferencing goes through operator[], so it
+        // yields values rather than references.
+        class CompressedVectorIterator{
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using difference_type   = std::ptrdiff_t;
+                using value_type        = T;
+                using pointer           = void;
+                using reference         = T;
+
+            private:
+                const compressed_tiered_vector* parent;
+                size_t idx;
+
+            public:
+                CompressedVectorIterator() : parent(nullptr), idx(0) {}
+                CompressedVectorIterator(const compressed_tiered_vector* v, size_t i) : parent(v), idx(i) {}
+
+                T operator*() const {return (*parent)[idx];}
+
+                CompressedVectorIterator& operator++(){++idx; return *this;}
+                CompressedVectorIterator operator++(int){CompressedVectorIterator tmp = *this; ++idx; return tmp;}
+                CompressedVectorIterator& operator--(){--idx; return *this;}
+                CompressedVectorIterator operator--(int){CompressedVectorIterator tmp = *this; --idx; return tmp;}
+
+                CompressedVectorIterator& operator+=(difference_type incr){idx += incr; return *this;}
+                CompressedVectorIterator& operator-=(difference_type incr){idx -= incr; return *this;}
+
+                friend CompressedVectorIterator operator+(CompressedVectorIterator it, difference_type incr){return it += incr;}
+                friend CompressedVectorIterator operator+(difference_type incr, CompressedVectorIterator it){return it += incr;}
+                friend CompressedVectorIterator operator-(CompressedVectorIterator it, difference_type incr){return it -= incr;}
+
+                friend difference_type operator-(const CompressedVectorIterator& a, const CompressedVectorIterator& b){return a.idx - b.idx;}
+
+                friend bool operator==(const CompressedVectorIterator& a, const CompressedVectorIterator& b){return a.idx == b.idx;}
+                friend bool operator!=(const CompressedVectorIterator& a, const CompressedVectorIterator& b){return a.idx != b.idx;}
+                friend bool operator<(const CompressedVectorIterator& a, const CompressedVectorIterator& b){return a.idx < b.idx;}
+                friend bool operator<=(const CompressedVectorIterator& a, const CompressedVectorIterator& b){return a.idx <= b.idx;}
+                friend bool operator>(const CompressedVectorIterator& a, const CompressedVectorIterator& b){return a.idx > b.idx;}
+                friend bool operator>=(const CompressedVectorIterator& a, const CompressedVectorIterator& b){return a.idx >= b.idx;}
+                T operator[](difference_type incr) const {return (*parent)[idx + incr];}
+        };
+
+    private:
+        // Arithmetic is done on uint64_t, modulo 2^64, so signed values and
+        // differences that overflow T round-trip exactly.
+        struct packed_block{
+            codec kind;
+            uint8_t width;
+            uint64_t first;     // delta: v[0]
+            uint64_t reference; // frame_of_reference: min; delta: min delta
+            std::vector<uint64_t> words;
+        };
+
+        struct cached_block{
+            size_t block;
+            uint64_t last_use;
+            std::unique_ptr<T[]> data;
+        };
+
+        std::vector<packed_block> sealed;
+        std::unique_ptr<T[]> tail;
+        size_t sz;
+
+        mutable std::vector<cached_block> cache;
+        mutable size_t last_block;
+        mutable const T* last_data;
+        mutable uint64_t tick;
+        mutable cache_stats_type counters;
+        size_t cache_limit;
+
+        static int64_t as_signed(uint64_t v) {return static_cast<int64_t>(v);}
+
+        static uint64_t widen(T v){
+            return static_cast<uint64_t>(static_cast<std::conditional_t<is_signed_v<T>, int64_t, uint64_t>>(v));
+        }
+
+        static uint8_t width_of(uint64_t span){return static_cast<uint8_t>(std::bit_width(span));}
+
+        static void pack(const uint64_t* offsets, size_t n, uint8_t width, std::vector<uint64_t>& words){
+            words.assign((n * width + 63) / 64, 0);
+            if(width == 0) return;
+            for(size_t i = 0; i < n; ++i){
+                size_t bit = i * width;
+                size_t w = bit >> 6;
+                size_t shift = bit & 63;
+                words[w] |= offsets[i] << shift;
+                if(shift + width > 64) words[w + 1] |= offsets[i] >> (64 - shift);
+            }
+        }
+
+        static uint64_t unpack(const uint64_t* words, size_t i, uint8_t width, uint64_t mask){
+            size_t bit = i * width;
+            size_t w = bit >> 6;
+            size_t shift = bit & 63;
+            uint64_t v = words[w] >> shift;
+            if(shift + width > 64) v |= words[w + 1] << (64 - shift);
+            return v & mask;
+        }
+
+        // Packs a full block with whichever codec gives the narrower width.
+        static packed_block compress(const T* values){
+            std::vector<uint64_t> raw(block_size);
+            std::vector<uint64_t> deltas(block_size);
+            for(size_t i = 0; i < block_size; ++i) raw[i] = widen(values[i]);
+
+            auto less = [](uint64_t a, uint64_t b){
+                return is_signed_v<T> ? as_signed(a) < as_signed(b) : a < b;
+            };
+            auto [lo, hi] = std::minmax_element(raw.begin(), raw.end(), less);
+            uint64_t min_value = *lo;
+            uint8_t for_width = width_of(*hi - min_value);
+
+            for(size_t i = 1; i < block_size; ++i) deltas[i] = raw[i] - raw[i - 1];
+            auto [dlo, dhi] = std::minmax_element(deltas.begin() + 1, deltas.end(),
+                [](uint64_t a, uint64_t b){ return as_signed(a) < as_signed(b); });
+            uint64_t min_delta = *dlo;
+            uint8_t delta_width = width_of(*dhi - min_delta);
+
+            packed_block p;
+            if(delta_width < for_width){
+                p.kind = codec::delta;
+                p.width = delta_width;
+                p.first = raw[0];
+                p.reference = min_delta;
+                deltas[0] = min_delta;
+                for(size_t i = 0; i < block_size; ++i) deltas[i] -= min_delta;
+                pack(deltas.data(), block_size, delta_width, p.words);
+            }
+            else{
+                p.kind = codec::frame_of_reference;
+                p.width = for_width;
+                p.first = 0;
+                p.reference = min_value;
+                for(size_t i = 0; i < block_size; ++i) raw[i] -= min_value;
+                pack(raw.data(), block_size, for_width, p.words);
+            }
+            return p;
+        }
+
+        static void decompress(const packed_block& p, T* out){
+            uint64_t mask = p.width == 64 ? ~uint64_t(0) : (uint64_t(1) << p.width) - 1;
+            const uint64_t* words = p.words.data();
+            if(p.kind == codec::frame_of_reference){
+                for(size_t i = 0; i < block_size; ++i){
+                    out[i] = static_cast<T>(p.reference + (p.width ? unpack(words, i, p.width, mask) : 0));
+                }
+                return;
+            }
+            uint64_t v = p.first;
+            out[0] = static_cast<T>(v);
+            for(size_t i = 1; i < block_size; ++i){
+                v += p.reference + (p.width ? unpack(words, i, p.width, mask) : 0);
+                out[i] = static_cast<T>(v);
+            }
+        }
+
+        // Element i of a block that does not need a prefix to decode.
+        static T element(const packed_block& p, size_t i){
+            if(p.kind == codec::delta) return static_cast<T>(p.first + i * p.reference);
+            uint64_t mask = p.width == 64 ? ~uint64_t(0) : (uint64_t(1) << p.width) - 1;
+            return static_cast<T>(p.reference + (p.width ? unpack(p.words.data(), i, p.width, mask) : 0));
+        }
+
+        // The block read last is remembered, so a run of reads in one block
+        // skips the cache lookup.
+        const T* cached(size_t b) const {
+            if(b == last_block){
+                counters.hits++;
+                return last_data;
+            }
+            ++tick;
+            for(cached_block& c : cache){
+                if(c.block == b){
+                    c.last_use = tick;
+                    counters.hits++;
+                    last_block = b;
+                    return last_data = c.data.get();
+                }
+            }
+            counters.misses++;
+
+            cached_block* slot;
+            if(cache.size() < cache_limit){
+                cache.push_back({b, tick, std::make_unique_for_overwrite<T[]>(block_size)});
+                slot = &cache.back();
+            }
+            else{
+                slot = &*std::min_element(cache.begin(), cache.end(),
+                    [](const cached_block& x, const cached_block& y){ return x.last_use < y.last_use; });
+                slot->block = b;
+                slot->last_use = tick;
+            }
+            decompress(sealed[b], slot->data.get());
+            last_block = b;
+            return last_data = slot->data.get();
+        }
+
+    public:
+        using value_type = T;
+        using const_iterator = CompressedVectorIterator;
+        using iterator = const_iterator;
+
+        explicit compressed_tiered_vector(size_t cache_blocks = 8) :
+            tail(std::make_unique_for_overwrite<T[]>(block_size)), sz(0),
+            last_block(SIZE_MAX), last_data(nullptr), tick(0), counters{}, cache_limit(std::max<size_t>(cache_blocks, 1)) {}
+
+        void push_back(T value){
+            tail[sz&block_mask] = value;
+            if((++sz&block_mask) == 0) sealed.push_back(compress(tail.get()));
+        }
+
+        T operator[](size_t idx) const {
+            size_t b = idx>>BlockBits;
+            if(b == sealed.size()) return tail[idx&block_mask];
+
+            const packed_block& p = sealed[b];
+            if(p.kind == codec::frame_of_reference || p.width == 0) return element(p, idx&block_mask);
+            return cached(b)[idx&block_mask];
+        }
+
+        // Overwrites element idx. A sealed block is decoded, changed and packed
+        // again, possibly with the other codec, so this is O(block_size).
+        void set(size_t idx, T value){
+            size_t b = idx>>BlockBits;
+            if(b == sealed.size()){
+                tail[idx&block_mask] = value;
+                return;
+            }
+            auto scratch = std::make_unique_for_overwrite<T[]>(block_size);
+            decompress(sealed[b], scratch.get());
+            scratch[idx&block_mask] = value;
+            sealed[b] = compress(scratch.get());
+            std::erase_if(cache, [b](const cached_block& c){ return c.block == b; });
+            last_block = SIZE_MAX;
+        }
+
+        T front() const {return (*this)[0];}
+        T back() const {return (*this)[sz - 1];}
+
+        // Calls f(std::span<const T>) for every block in order. Sealed blocks
+        // are decoded into one scratch buffer, so a span is only valid during
+        // its call.
+        template <typename F>
+        void for_each_segment(F&& f) const {
+            auto scratch = std::make_unique_for_overwrite<T[]>(block_size);
+            for(const packed_block& p : sealed){
+                decompress(p, scratch.get());
+                f(std::span<const T>(scratch.get(), block_size));
+            }
+            if((sz&block_mask) != 0) f(std::span<const T>(tail.get(), sz&block_mask));
+        }
+
+        void clear(){
+            sealed.clear();
+            cache.clear();
+            last_block = SIZE_MAX;
+            sz = 0;
+        }
+
+        // Resizes the LRU cache of decoded blocks (at least one).
+        void set_cache_blocks(size_t n){
+            cache_limit = std::max<size_t>(n, 1);
+            if(cache.size() > cache_limit){
+                std::sort(cache.begin(), cache.end(),
+                    [](const cached_block& x, const cached_block& y){ return x.last_use > y.last_use; });
+                cache.resize(cache_limit);
+                last_block = SIZE_MAX;
+            }
+        }
+
+        size_t cache_blocks() const {return cache_limit;}
+        cache_stats_type cache_stats() const {return counters;}
+
+        // The codec chosen for sealed block b and its bits per element.
+        codec block_codec(size_t b) const {return sealed[b].kind;}
+        size_t block_width(size_t b) const {return sealed[b].width;}
+
+        // Bytes held by element data: packed blocks, the filling block and
+        // the decoded-block cache. raw_bytes() is the same data uncompressed.
+        size_t memory_usage() const {
+            size_t bytes = sealed.capacity() * sizeof(packed_block) + block_size * sizeof(T);
+            for(const packed_block& p : sealed) bytes += p.words.capacity() * sizeof(uint64_t);
+            return bytes + cache.size() * block_size * sizeof(T);
+        }
+
+        size_t raw_bytes() const {return sz * sizeof(T);}
+
+        double compression_ratio() const {
+            return memory_usage() == 0 ? 0.0 : double(raw_bytes()) / memory_usage();
+        }
+
+        const_iterator begin() const {return const_iterator(this, 0);}
+        const_iterator end() const {return const_iterator(this, sz);}
+
+        size_t size() const {return sz;}
+        bool empty() const {return sz == 0;}
+        size_t segment_count() const {return sealed.size() + ((sz&block_mask) != 0);}
+};
+
+}
@@ -0,0 +1,266 @@
+#pragma once
+#include "tiered_vector.hpp"
+
+namespace cppx {
+
+// Multi-producer append container in the spirit of TBB's concurrent_vector.
+//
+// Any number of threads may push_back/emplace_back/grow_by and index
+// concurrently. Each append atomically reserves its index range with one
+// fetch_add and then constructs its elements in place, so the returned
+// references are stable for the container's lifetime.
+//
+// The spine never moves: block slots live in spine segments of doubling size
+// (8, 8, 16, 32, ... slots) hung off a fixed array, so growing it only ever
+// publishes new memory and a reader holding a block or element pointer is
+// never invalidated. Blocks and segments are installed with a CAS; a thread
+// that loses the race frees its copy and uses the winner's.
+//
+// size() counts reserved elements, like TBB: an element is only safe to read
+// once the thread that appended it has published it (e.g. through the returned
+// reference, a join or a flag). clear(), reserve() racing with clear(), and
+// destruction are not thread-safe. The allocator is called from several
+// threads at once, so with std::pmr use a synchronized resource.
+//
+// If T's constructor throws, the exception propagates but the index range was
+// already reserved: those slots stay counted in size() and hold no object.
+// They are recorded (under a mutex, only on that path, so appends pay
+// nothing) and clear() and the destructor skip them. Reading one is undefined.
+// Types with nothrow construction never reach that path.
+template <typename T, size_t BlockBits = default_block_bits<T>(), typename Allocator = std::allocator<T>>
+class concurrent_tiered_vector{
+    static_assert(BlockBits > 0 && BlockBits < 32, "BlockBits must be in [1, 31]");
+
+    public:
+        static constexpr size_t block_bits = BlockBits;
+        static constexpr size_t block_size = size_t(1) << BlockBits;
+        static constexpr size_t block_mask = block_size - 1;
+
+        template <bool is_const>
+        class ConcurrentVectorIterator{
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using difference_type   = std::ptrdiff_t;
+                using value_type        = T;
+                using pointer           = std::conditional_t<is_const, const T*, T*>;
+                using reference         = std::conditional_t<is_const, const T&, T&>;
+                using parent_type       = std::conditional_t<is_const, const concurrent_tiered_vector*, concurrent_tiered_vector*>;
+
+            private:
+                template <bool> friend class ConcurrentVectorIterator;
+
+                parent_type parent;
+                size_t idx;
+
+            public:
+                ConcurrentVectorIterator() : parent(nullptr), idx(0) {}
+                ConcurrentVectorIterator(parent_type v, size_t i) : parent(v), idx(i) {}
+
+                template <bool other_const, typename = std::enable_if_t<is_const && !other_const>>
+                ConcurrentVectorIterator(const ConcurrentVectorIterator<other_const>& other) : parent(other.parent), idx(other.idx) {}
+
+                reference operator*() const {return (*parent)[idx];}
+                pointer operator->() const {return &(*parent)[idx];}
+
+                ConcurrentVectorIterator& operator++(){++idx; return *this;}
+                ConcurrentVectorIterator operator++(int){ConcurrentVectorIterator tmp = *this; ++idx; return tmp;}
+                ConcurrentVectorIterator& operator--(){--idx; return *this;}
+                ConcurrentVectorIterator operator--(int){ConcurrentVectorIterator tmp = *this; --idx; return tmp;}
+
+                ConcurrentVectorIterator& operator+=(difference_type incr){idx += incr; return *this;}
+                ConcurrentVectorIterator& operator-=(difference_type incr){idx -= incr; return *this;}
+
+                friend ConcurrentVectorIterator operator+(ConcurrentVectorIterator it, difference_type incr){return it += incr;}
+                friend ConcurrentVectorIterator operator+(difference_type incr, ConcurrentVectorIterator it){return it += incr;}
+                friend ConcurrentVectorIterator operator-(ConcurrentVectorIterator it, difference_type incr){return it -= incr;}
+
+                friend difference_type operator-(const ConcurrentVectorIterator& a, const ConcurrentVectorIterator& b){return a.idx - b.idx;}
+
+                friend bool operator==(const ConcurrentVectorIterator& a, const ConcurrentVectorIterator& b){return a.idx == b.idx;}
+                friend bool operator!=(const ConcurrentVectorIterator& a, const ConcurrentVectorIterator& b){return a.idx != b.idx;}
+                friend bool operator<(const ConcurrentVectorIterator& a, const ConcurrentVectorIterator& b){return a.idx < b.idx;}
+                friend bool operator<=(const ConcurrentVectorIterator& a, const ConcurrentVectorIterator& b){return a.idx <= b.idx;}
+                friend bool operator>(const ConcurrentVectorIterator& a, const ConcurrentVectorIterator& b){return a.idx > b.idx;}
+                friend bool operator>=(const ConcurrentVectorIterator& a, const ConcurrentVectorIterator& b){return a.idx >= b.idx;}
+                reference operator[](difference_type incr) const {return (*parent)[idx + incr];}
+        };
+
+    private:
+        using alloc_traits   = std::allocator_traits<Allocator>;
+        using slot_type      = std::atomic<T*>;
+        using slot_allocator = typename alloc_traits::template rebind_alloc<slot_type>;
+        using slot_traits    = std::allocator_traits<slot_allocator>;
+
+        static_assert(is_same_v<typename alloc_traits::pointer, T*>, "fancy pointers are not supported");
+
+        static constexpr size_t first_segment_bits = 3;
+        static constexpr size_t max_segments = 65 - BlockBits - first_segment_bits;
+
+        std::atomic<slot_type*> spine[max_segments];
+        std::atomic<size_t> reserved;
+        [[no_unique_address]] Allocator alloc;
+        // [first, last) index ranges whose construction threw.
+        std::vector<std::pair<size_t, size_t>> unbuilt;
+        std::mutex unbuilt_mtx;
+
+        void mark_unbuilt(size_t first, size_t last){
+            std::lock_guard<std::mutex> lock(unbuilt_mtx);
+            unbuilt.emplace_back(first, last);
+        }
+
+        // Block b lives in segment bit_width(b >> first_segment_bits); segment 0
+        // and 1 hold 8 slots each, every later segment twice the previous one.
+        static size_t segment_of(size_t b){return std::bit_width(b >> first_segment_bits);}
+        static size_t segment_base(size_t k){return k == 0 ? 0 : size_t(1) << (first_segment_bits + k - 1);}
+        static size_t segment_slots(size_t k){return size_t(1) << (first_segment_bits + (k == 0 ? 0 : k - 1));}
+
+        slot_type* segment(size_t k){
+            slot_type* seg = spine[k].load(std::memory_order_acquire);
+            if(seg != nullptr) return seg;
+
+            slot_allocator slot_alloc(alloc);
+            slot_type* fresh = slot_traits::allocate(slot_alloc, segment_slots(k));
+            for(size_t i = 0; i < segment_slots(k); ++i) ::new (static_cast<void*>(fresh + i)) slot_type(nullptr);
+
+            if(spine[k].compare_exchange_strong(seg, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) return fresh;
+            slot_traits::deallocate(slot_alloc, fresh, segment_slots(k));
+            return seg;
+        }
+
+        T* block(size_t b){
+            size_t k = segment_of(b);
+            slot_type& slot = segment(k)[b - segment_base(k)];
+            T* blk = slot.load(std::memory_order_acquire);
+            if(blk != nullptr) return blk;
+
+            T* fresh = alloc_traits::allocate(alloc, block_size);
+            if(slot.compare_exchange_strong(blk, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) return fresh;
+            alloc_traits::deallocate(alloc, fresh, block_size);
+            return blk;
+        }
+
+        // Reader path: the block must already exist (idx < size()).
+        T* element(size_t idx) const {
+            size_t b = idx>>BlockBits;
+            size_t k = segment_of(b);
+            return spine[k].load(std::memory_order_acquire)[b - segment_base(k)].load(std::memory_order_acquire) + (idx&block_mask);
+        }
+
+        template <typename Construct>
+        size_t grow_with(size_t n, Construct construct){
+            size_t first = reserved.fetch_add(n, std::memory_order_relaxed);
+            size_t i = first;
+            size_t last = first + n;
+            try{
+                while(i < last){
+                    T* blk = block(i>>BlockBits);
+                    size_t seg_end = std::min(last, (i | block_mask) + 1);
+                    for(; i < seg_end; ++i) construct(blk + (i&block_mask), i - first);
+                }
+            }
+            catch(...){
+                mark_unbuilt(i, last);
+                throw;
+            }
+            return first;
+        }
+
+    public:
+        using allocator_type = Allocator;
+        using iterator = ConcurrentVectorIterator<false>;
+        using const_iterator = ConcurrentVectorIterator<true>;
+
+        concurrent_tiered_vector() : concurrent_tiered_vector(Allocator()) {}
+
+        explicit concurrent_tiered_vector(const Allocator& a) : reserved(0), alloc(a){
+            for(auto& seg : spine) seg.store(nullptr, std::memory_order_relaxed);
+        }
+
+        concurrent_tiered_vector(const concurrent_tiered_vector&) = delete;
+        concurrent_tiered_vector& operator= (const concurrent_tiered_vector&) = delete;
+
+        ~concurrent_tiered_vector(){
+            clear();
+            for(size_t k = 0; k < max_segments; ++k){
+                slot_type* seg = spine[k].load(std::memory_order_acquire);
+                if(seg == nullptr) continue;
+                for(size_t i = 0; i < segment_slots(k); ++i){
+                    T* blk = seg[i].load(std::memory_order_relaxed);
+                    if(blk != nullptr) alloc_traits::deallocate(alloc, blk, block_size);
+                }
+                slot_allocator slot_alloc(alloc);
+                slot_traits::deallocate(slot_alloc, seg, segment_slots(k));
+            }
+        }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args){
+            size_t idx = reserved.fetch_add(1, std::memory_order_relaxed);
+            try{
+                T* slot = block(idx>>BlockBits) + (idx&block_mask);
+                alloc_traits::construct(alloc, slot, std::forward<Args>(args)...);
+                return *slot;
+            }
+            catch(...){
+                mark_unbuilt(idx, idx + 1);
+                throw;
+            }
+        }
+
+        T& push_back(const T& value){return emplace_back(value);}
+        T& push_back(T&& value){return emplace_back(move(value));}
+
+        // Appends n elements as one contiguous index range and returns an
+        // iterator to the first of them.
+        iterator grow_by(size_t n){
+            return iterator(this, grow_with(n, [this](T* slot, size_t){ alloc_traits::construct(alloc, slot); }));
+        }
+
+        iterator grow_by(size_t n, const T& value){
+            return iterator(this, grow_with(n, [this, &value](T* slot, size_t){ alloc_traits::construct(alloc, slot, value); }));
+        }
+
+        template <std::random_access_iterator It>
+        iterator grow_by(It first, It last){
+            return iterator(this, grow_with(static_cast<size_t>(last - first),
+                [this, first](T* slot, size_t k){ alloc_traits::construct(alloc, slot, first[k]); }));
+        }
+
+        // Pre-allocates the blocks for the first n elements so appends up to n
+        // never hit the allocator or race on a block slot.
+        void reserve(size_t n){
+            for(size_t b = 0; b < ((n + block_mask) >> BlockBits); ++b) block(b);
+        }
+
+        // Not thread-safe. Destroys the elements and keeps the blocks.
+        void clear(){
+            size_t n = reserved.load(std::memory_order_acquire);
+            if constexpr (!is_trivially_destructible_v<T>){
+                std::sort(unbuilt.begin(), unbuilt.end());
+                auto hole = unbuilt.begin();
+                for(size_t i = 0; i < n; ++i){
+                    if(hole != unbuilt.end() && i == hole->first){
+                        i = hole++->second - 1;
+                        continue;
+                    }
+                    alloc_traits::destroy(alloc, element(i));
+                }
+            }
+            unbuilt.clear();
+            reserved.store(0, std::memory_order_release);
+        }
+
+        T& operator[](size_t idx){return *element(idx);}
+        const T& operator[](size_t idx) const {return *element(idx);}
+
+        iterator begin() {return iterator(this, 0);}
+        iterator end() {return iterator(this, size());}
+        const_iterator begin() const {return const_iterator(this, 0);}
+        const_iterator end() const {return const_iterator(this, size());}
+
+        size_t size() const {return reserved.load(std::memory_order_acquire);}
+        bool empty() const {return size() == 0;}
+        allocator_type get_allocator() const {return alloc;}
+};
+
+}
@@ -0,0 +1,439 @@
+#pragma once
+#include "tiered_vector.hpp"
+
+namespace cppx {
+
+// tiered_vector with copy-on-write blocks, for cheap read-only snapshots of
+// large containers.
+//
+// Blocks are reference counted. Copying the container (or calling snapshot())
+// copies the spine and bumps every block's count, O(blocks) instead of O(n).
+// A shared block is duplicated the first time it is written: through the
+// non-const operator[], front()/back(), segment() or iterators, or by
+// push_back, pop_back or resize touching it. Non-const access counts as a
+// write whether or not the element changes, so read a shared container through
+// a const reference (cbegin(), std::as_const) to keep its blocks shared.
+//
+// As with the old copy-on-write std::string, a block that has handed out a
+// mutable reference, pointer, span or iterator (or the result of emplace_back)
+// is marked unshareable: later copies and snapshots duplicate it instead of
+// sharing it, so a handle kept across snapshot() can only write to the
+// original. The mark lasts until the block is dropped; push_back, pop_back
+// and resize do not set it.
+//
+// Counts are atomic, so a snapshot can be read and destroyed on another thread
+// while the original keeps writing. Duplicating a block moves its elements,
+// which invalidates references into it; tiered_vector promises stable
+// references, which is why this is a separate container.
+template <typename T, size_t BlockBits = default_block_bits<T>(), typename Allocator = std::allocator<T>>
+class cow_tiered_vector{
+    static_assert(BlockBits > 0 && BlockBits < 32, "BlockBits must be in [1, 31]");
+
+    public:
+        static constexpr size_t block_bits = BlockBits;
+        static constexpr size_t block_size = size_t(1) << BlockBits;
+        static constexpr size_t block_mask = block_size - 1;
+
+        template <bool is_const>
+        class CowVectorIterator{
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using difference_type   = std::ptrdiff_t;
+                using value_type        = T;
+                using pointer           = std::conditional_t<is_const, const T*, T*>;
+                using reference         = std::conditional_t<is_const, const T&, T&>;
+                using parent_type       = std::conditional_t<is_const, const cow_tiered_vector*, cow_tiered_vector*>;
+
+            private:
+                template <bool> friend class CowVectorIterator;
+
+                // Cursor into the current block, as in tiered_vector. Loading a
+                // block through a non-const parent unshares it.
+                parent_type parent;
+                pointer cur;
+                pointer last;
+                size_t block;
+
+                void load(size_t b){
+                    block = b;
+                    if(b < parent->spine.size()){
+                        cur = parent->block_data(b);
+                        last = cur + block_size;
+                    }
+                    else{
+                        cur = last = nullptr;
+                    }
+                }
+
+                void seek(size_t i){
+                    load(i>>BlockBits);
+                    if(cur != nullptr) cur += (i&block_mask);
+                }
+
+                size_t index() const {
+                    return (block<<BlockBits) + (cur != nullptr ? size_t(cur - (last - block_size)) : 0);
+                }
+
+            public:
+                CowVectorIterator() : parent(nullptr), cur(nullptr), last(nullptr), block(0) {}
+                CowVectorIterator(parent_type v, size_t i) : parent(v) {seek(i);}
+
+                template <bool other_const, typename = std::enable_if_t<is_const && !other_const>>
+                CowVectorIterator(const CowVectorIterator<other_const>& other) :
+                    parent(other.parent), cur(other.cur), last(other.last), block(other.block) {}
+
+                reference operator*() const {return *cur;}
+                pointer operator->() const {return cur;}
+
+                CowVectorIterator& operator++(){
+                    if(++cur == last) load(block + 1);
+                    return *this;
+                }
+                CowVectorIterator operator++(int){CowVectorIterator tmp = *this; ++(*this); return tmp;}
+                CowVectorIterator& operator--(){
+                    if(cur == nullptr || cur == last - block_size){
+                        load(block - 1);
+                        cur = last;
+                    }
+                    --cur;
+                    return *this;
+                }
+                CowVectorIterator operator--(int){CowVectorIterator tmp = *this; --(*this); return tmp;}
+
+                CowVectorIterator& operator+=(difference_type incr){
+                    size_t next = index() + incr;
+                    if(cur != nullptr && (next>>BlockBits) == block) cur += incr;
+                    else seek(next);
+                    return *this;
+                }
+                CowVectorIterator& operator-=(difference_type incr){return *this += -incr;}
+
+                friend CowVectorIterator operator+(CowVectorIterator it, difference_type incr){return it += incr;}
+                friend CowVectorIterator operator+(difference_type incr, CowVectorIterator it){return it += incr;}
+                friend CowVectorIterator operator-(CowVectorIterator it, difference_type incr){return it -= incr;}
+
+                friend difference_type operator-(const CowVectorIterator& a, const CowVectorIterator& b){return a.index() - b.index();}
+
+                friend bool operator==(const CowVectorIterator& a, const CowVectorIterator& b){return a.cur == b.cur;}
+                friend bool operator!=(const CowVectorIterator& a, const CowVectorIterator& b){return !(a == b);}
+                friend bool operator<(const CowVectorIterator& a, const CowVectorIterator& b){return a.index() < b.index();}
+                friend bool operator<=(const CowVectorIterator& a, const CowVectorIterator& b){return a.index() <= b.index();}
+                friend bool operator>(const CowVectorIterator& a, const CowVectorIterator& b){return a.index() > b.index();}
+                friend bool operator>=(const CowVectorIterator& a, const CowVectorIterator& b){return a.index() >= b.index();}
+                reference operator[](difference_type incr) const {return *(*this + incr);}
+        };
+
+    private:
+        // Elements [0, used) of storage are constructed. Every holder of a block
+        // sees the same used count, because changing it is a write. Only an
+        // unshared block is ever marked unshareable, and copies never share it
+        // afterwards, so the flag is only written by its single holder.
+        struct shared_block{
+            std::atomic<size_t> refs;
+            size_t used;
+            bool unshareable;
+            alignas(T) unsigned char storage[block_size * sizeof(T)];
+
+            T* data() {return reinterpret_cast<T*>(storage);}
+        };
+
+        using alloc_traits = std::allocator_traits<Allocator>;
+        using node_allocator = typename alloc_traits::template rebind_alloc<shared_block>;
+        using node_traits = std::allocator_traits<node_allocator>;
+        using spine_allocator = typename alloc_traits::template rebind_alloc<shared_block*>;
+
+        static_assert(is_same_v<typename alloc_traits::pointer, T*>, "fancy pointers are not supported");
+
+        std::vector<shared_block*, spine_allocator> spine;
+        size_t sz;
+        [[no_unique_address]] Allocator alloc;
+
+        shared_block* new_block(){
+            node_allocator node_alloc(alloc);
+            shared_block* b = node_traits::allocate(node_alloc, 1);
+            ::new (static_cast<void*>(b)) shared_block;
+            b->refs.store(1, std::memory_order_relaxed);
+            b->used = 0;
+            b->unshareable = false;
+            return b;
+        }
+
+        void free_block(shared_block* b){
+            for(size_t i = 0; i < b->used; ++i) alloc_traits::destroy(alloc, b->data() + i);
+            b->~shared_block();
+            node_allocator node_alloc(alloc);
+            node_traits::deallocate(node_alloc, b, 1);
+        }
+
+        void release_block(shared_block* b){
+            if(b->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) free_block(b);
+        }
+
+        shared_block* clone_block(shared_block* src){
+            shared_block* b = new_block();
+            try{
+                for(; b->used < src->used; ++b->used){
+                    alloc_traits::construct(alloc, b->data() + b->used, std::as_const(src->data()[b->used]));
+                }
+            }
+            catch(...){
+                free_block(b);
+                throw;
+            }
+            return b;
+        }
+
+        // Block b, duplicated first if anyone else holds it. A count of one can
+        // only be ours: no other holder exists to raise it.
+        shared_block* own(size_t b){
+            shared_block*& blk = spine[b];
+            if(blk->refs.load(std::memory_order_acquire) != 1){
+                shared_block* copy = clone_block(blk);
+                release_block(blk);
+                blk = copy;
+            }
+            return blk;
+        }
+
+        // Block b, owned and marked unshareable, for a handle the caller keeps.
+        shared_block* pin(size_t b){
+            shared_block* blk = own(b);
+            blk->unshareable = true;
+            return blk;
+        }
+
+        // A block for a new holder: shared, or a private copy if it is pinned.
+        shared_block* share(shared_block* b){
+            if(b->unshareable) return clone_block(b);
+            b->refs.fetch_add(1, std::memory_order_relaxed);
+            return b;
+        }
+
+        T* block_data(size_t b) {return pin(b)->data();}
+        const T* block_data(size_t b) const {return spine[b]->data();}
+
+        void add_block(){
+            shared_block* b = new_block();
+            try{
+                spine.push_back(b);
+            }
+            catch(...){
+                free_block(b);
+                throw;
+            }
+        }
+
+        void drop_back_block(){
+            release_block(spine.back());
+            spine.pop_back();
+        }
+
+        void release_all(){
+            for(shared_block* b : spine) release_block(b);
+            spine.clear();
+            sz = 0;
+        }
+
+        template <typename Construct>
+        void resize_with(size_t new_size, Construct construct){
+            if(new_size < sz){
+                while(spine.size() > ((new_size + block_mask) >> BlockBits)) drop_back_block();
+                sz = new_size;
+                if((sz&block_mask) != 0){
+                    shared_block* b = own(spine.size() - 1);
+                    while(b->used > (sz&block_mask)) alloc_traits::destroy(alloc, b->data() + --b->used);
+                }
+                return;
+            }
+            while(sz < new_size){
+                if((sz&block_mask) == 0) add_block();
+                shared_block* b = own(sz>>BlockBits);
+                try{
+                    construct(b->data() + b->used);
+                }
+                catch(...){
+                    if(b->used == 0) drop_back_block();
+                    throw;
+                }
+                b->used++;
+                sz++;
+            }
+        }
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using iterator = CowVectorIterator<false>;
+        using const_iterator = CowVectorIterator<true>;
+
+        cow_tiered_vector() : cow_tiered_vector(Allocator()) {}
+
+        explicit cow_tiered_vector(const Allocator& a) : spine(spine_allocator(a)), sz(0), alloc(a) {}
+
+        cow_tiered_vector(initializer_list<T> values, const Allocator& a = Allocator()) : cow_tiered_vector(a){
+            reserve(values.size());
+            for(const T& v : values) push_back(v);
+        }
+
+        // Shares every block with value: O(blocks), no element is copied except
+        // in blocks value has pinned.
+        cow_tiered_vector(const cow_tiered_vector& value) :
+            spine(spine_allocator(value.alloc)), sz(0), alloc(value.alloc)
+        {
+            spine.reserve(value.spine.size());
+            try{
+                for(shared_block* b : value.spine) spine.push_back(share(b));
+            }
+            catch(...){
+                release_all();
+                throw;
+            }
+            sz = value.sz;
+        }
+
+        cow_tiered_vector(cow_tiered_vector&& value) noexcept :
+            spine(move(value.spine)), sz(value.sz), alloc(value.alloc)
+        {
+            value.spine.clear();
+            value.sz = 0;
+        }
+
+        ~cow_tiered_vector(){
+            release_all();
+        }
+
+        cow_tiered_vector& operator= (const cow_tiered_vector& value){
+            if(this == &value) return *this;
+
+            cow_tiered_vector tmp(value);
+            swap(tmp);
+            return *this;
+        }
+
+        cow_tiered_vector& operator= (cow_tiered_vector&& value) noexcept {
+            if(this == &value) return *this;
+
+            release_all();
+            spine = move(value.spine);
+            sz = value.sz;
+            alloc = value.alloc;
+            value.spine.clear();
+            value.sz = 0;
+            return *this;
+        }
+
+        void swap(cow_tiered_vector& other) noexcept {
+            spine.swap(other.spine);
+            std::swap(sz, other.sz);
+            std::swap(alloc, other.alloc);
+        }
+
+        // A copy that shares all blocks with *this but the pinned ones. Spelled
+        // out for call sites that want to make the cheap copy obvious.
+        cow_tiered_vector snapshot() const {
+            return cow_tiered_vector(*this);
+        }
+
+        allocator_type get_allocator() const {return alloc;}
+
+        // Pins the last block, since the result is a mutable reference.
+        template <typename... Args>
+        T& emplace_back(Args&&... args){
+            resize_with(sz + 1, [&](T* s){ alloc_traits::construct(alloc, s, std::forward<Args>(args)...); });
+            return back();
+        }
+
+        void push_back(const T& value){
+            resize_with(sz + 1, [&](T* s){ alloc_traits::construct(alloc, s, value); });
+        }
+
+        void push_back(T&& value){
+            resize_with(sz + 1, [&](T* s){ alloc_traits::construct(alloc, s, move(value)); });
+        }
+
+        // Popping the last element of a block drops the block without copying it.
+        void pop_back(){
+            if(sz == 0) return;
+
+            if(((sz - 1)&block_mask) == 0){
+                drop_back_block();
+            }
+            else{
+                shared_block* b = own(spine.size() - 1);
+                alloc_traits::destroy(alloc, b->data() + --b->used);
+            }
+            sz--;
+        }
+
+        void resize(size_t new_size){
+            resize_with(new_size, [this](T* slot){ alloc_traits::construct(alloc, slot); });
+        }
+
+        void resize(size_t new_size, const T& value){
+            resize_with(new_size, [this, &value](T* slot){ alloc_traits::construct(alloc, slot, value); });
+        }
+
+        void reserve(size_t n){
+            spine.reserve((n + block_mask) >> BlockBits);
+        }
+
+        void clear(){
+            release_all();
+        }
+
+        T& operator[](size_t idx){
+            return block_data(idx>>BlockBits)[idx&block_mask];
+        }
+
+        const T& operator[](size_t idx) const {
+            return spine[idx>>BlockBits]->data()[idx&block_mask];
+        }
+
+        T& front() {return (*this)[0];}
+        const T& front() const {return (*this)[0];}
+        T& back() {return (*this)[sz - 1];}
+        const T& back() const {return (*this)[sz - 1];}
+
+        // Block b as a span over its live elements; b < segment_count().
+        std::span<T> segment(size_t b){
+            shared_block* blk = pin(b);
+            return std::span<T>(blk->data(), blk->used);
+        }
+
+        std::span<const T> segment(size_t b) const {
+            return std::span<const T>(spine[b]->data(), spine[b]->used);
+        }
+
+        size_t segment_count() const {return spine.size();}
+
+        template <typename F>
+        void for_each_segment(F&& f){
+            for(size_t b = 0; b < segment_count(); ++b) f(segment(b));
+        }
+
+        template <typename F>
+        void for_each_segment(F&& f) const {
+            for(size_t b = 0; b < segment_count(); ++b) f(segment(b));
+        }
+
+        // Blocks this container currently shares with another copy. Pinned
+        // blocks are never shared.
+        size_t shared_block_count() const {
+            size_t n = 0;
+            for(shared_block* b : spine) n += b->refs.load(std::memory_order_relaxed) != 1;
+            return n;
+        }
+
+        iterator begin() {return iterator(this, 0);}
+        iterator end() {return iterator(this, sz);}
+        const_iterator begin() const {return const_iterator(this, 0);}
+        const_iterator end() const {return const_iterator(this, sz);}
+        const_iterator cbegin() const {return begin();}
+        const_iterator cend() const {return end();}
+
+        size_t size() const {return sz;}
+        size_t capacity() const {return spine.size()<<BlockBits;}
+        bool empty() const {return sz == 0;}
+};
+
+}
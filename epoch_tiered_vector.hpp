@@ -0,0 +1,245 @@
+#pragma once
+#include "tiered_vector.hpp"
+
+namespace cppx {
+
+// Single-writer, many-reader tiered vector whose readers never block, not
+// even while the spine is reallocated.
+//
+// One thread appends (push_back/emplace_back/reserve). When the spine is
+// full, the writer copies it into one twice the size, publishes the new
+// pointer atomically and retires the old spine instead of freeing it. Old
+// spines are freed with epoch-based reclamation: every reader owns a slot
+// in which it records the global epoch while it is pinned, and a spine
+// retired in epoch e is freed once no slot still shows an epoch <= e.
+// Blocks never move, so only the spine needs this.
+//
+// Reader threads call reader() once to claim a slot and then pin() around
+// a batch of accesses. Inside a pin, size() and operator[] are wait-free:
+// one atomic load of the spine pointer plus the usual shift and mask. An
+// element is readable once size() covers it. The writer publishes the size
+// after constructing the element. A pin held for a long time only delays
+// freeing old spines, which together are smaller than the current one.
+// clear() and destruction need all readers to be gone.
+template <typename T, size_t BlockBits = default_block_bits<T>(), typename Allocator = std::allocator<T>>
+class epoch_tiered_vector{
+    static_assert(BlockBits > 0 && BlockBits < 32, "BlockBits must be in [1, 31]");
+
+    public:
+        static constexpr size_t block_bits = BlockBits;
+        static constexpr size_t block_size = size_t(1) << BlockBits;
+        static constexpr size_t block_mask = block_size - 1;
+        static constexpr size_t max_readers = 128;
+
+    private:
+        using alloc_traits    = std::allocator_traits<Allocator>;
+        using spine_allocator = typename alloc_traits::template rebind_alloc<T*>;
+        using spine_traits    = std::allocator_traits<spine_allocator>;
+
+        static_assert(is_same_v<typename alloc_traits::pointer, T*>, "fancy pointers are not supported");
+
+        // epoch is 0 while the reader is not pinned. Padded so readers don't
+        // share a cache line.
+        struct alignas(64) reader_slot{
+            std::atomic<uint64_t> epoch{0};
+            std::atomic<bool> taken{false};
+        };
+
+        struct retired_spine{
+            T** slots;
+            size_t capacity;
+            uint64_t epoch;
+        };
+
+        std::atomic<T**> spine;
+        std::atomic<size_t> published;
+        std::atomic<uint64_t> global_epoch;
+        mutable reader_slot readers[max_readers];
+
+        // Writer-only state.
+        size_t sz;
+        size_t block_count;
+        size_t spine_cap;
+        std::vector<retired_spine> retired;
+        [[no_unique_address]] Allocator alloc;
+
+        T** allocate_spine(size_t n){
+            spine_allocator spine_alloc(alloc);
+            return spine_traits::allocate(spine_alloc, n);
+        }
+
+        void deallocate_spine(T** slots, size_t n){
+            spine_allocator spine_alloc(alloc);
+            spine_traits::deallocate(spine_alloc, slots, n);
+        }
+
+        // Copies the spine into one of new_cap slots and publishes it. The
+        // old spine is retired in the current epoch, and the epoch advances, so
+        // a reader pinned from now on can only have loaded the new spine.
+        void grow_spine(size_t new_cap){
+            T** old = spine.load(std::memory_order_relaxed);
+            T** fresh = allocate_spine(new_cap);
+            if(block_count > 0) std::memcpy(fresh, old, block_count * sizeof(T*));
+
+            if(old != nullptr) retired.reserve(retired.size() + 1);
+            spine.store(fresh, std::memory_order_seq_cst);
+            if(old != nullptr){
+                retired.push_back({old, spine_cap, global_epoch.fetch_add(1, std::memory_order_seq_cst)});
+            }
+            spine_cap = new_cap;
+            reclaim();
+        }
+
+        void add_block(){
+            if(block_count == spine_cap) grow_spine(spine_cap == 0 ? 8 : spine_cap * 2);
+            T** slots = spine.load(std::memory_order_relaxed);
+            slots[block_count] = alloc_traits::allocate(alloc, block_size);
+            block_count++;
+        }
+
+        // Oldest epoch a pinned reader may still be using, or UINT64_MAX.
+        uint64_t oldest_pinned() const {
+            uint64_t oldest = UINT64_MAX;
+            for(const reader_slot& r : readers){
+                uint64_t e = r.epoch.load(std::memory_order_seq_cst);
+                if(e != 0) oldest = std::min(oldest, e);
+            }
+            return oldest;
+        }
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+
+        // Keeps the reader pinned for its lifetime.
+        class pin_guard{
+            reader_slot* slot;
+
+            public:
+                explicit pin_guard(reader_slot* s) : slot(s) {}
+                pin_guard(const pin_guard&) = delete;
+                pin_guard& operator= (const pin_guard&) = delete;
+                ~pin_guard(){slot->epoch.store(0, std::memory_order_release);}
+        };
+
+        // A claimed reader slot. Use one per reader thread; it is not shared.
+        class reader_handle{
+            const epoch_tiered_vector* parent;
+            reader_slot* slot;
+
+            public:
+                reader_handle(const epoch_tiered_vector* v, reader_slot* s) : parent(v), slot(s) {}
+                reader_handle(reader_handle&& other) noexcept : parent(other.parent), slot(other.slot) {other.slot = nullptr;}
+                reader_handle(const reader_handle&) = delete;
+                reader_handle& operator= (const reader_handle&) = delete;
+
+                ~reader_handle(){
+                    if(slot != nullptr) slot->taken.store(false, std::memory_order_release);
+                }
+
+                // The seq_cst store pairs with the writer's seq_cst spine
+                // publication: either the writer sees this pin and keeps the
+                // old spine, or this reader loads the new one.
+                [[nodiscard]] pin_guard pin() const {
+                    slot->epoch.store(parent->global_epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+                    return pin_guard(slot);
+                }
+        };
+
+        epoch_tiered_vector() : epoch_tiered_vector(Allocator()) {}
+
+        explicit epoch_tiered_vector(const Allocator& a) :
+            spine(nullptr), published(0), global_epoch(1), sz(0), block_count(0), spine_cap(0), alloc(a) {}
+
+        epoch_tiered_vector(const epoch_tiered_vector&) = delete;
+        epoch_tiered_vector& operator= (const epoch_tiered_vector&) = delete;
+
+        ~epoch_tiered_vector(){
+            clear();
+            T** slots = spine.load(std::memory_order_relaxed);
+            for(size_t b = 0; b < block_count; ++b) alloc_traits::deallocate(alloc, slots[b], block_size);
+            if(slots != nullptr) deallocate_spine(slots, spine_cap);
+            for(const retired_spine& r : retired) deallocate_spine(r.slots, r.capacity);
+        }
+
+        // Claims a reader slot; throws std::runtime_error when all
+        // max_readers slots are in use.
+        reader_handle reader() const {
+            for(reader_slot& slot : readers){
+                bool expected = false;
+                if(!slot.taken.load(std::memory_order_relaxed) &&
+                   slot.taken.compare_exchange_strong(expected, true, std::memory_order_acquire)){
+                    return reader_handle(this, &slot);
+                }
+            }
+            throw std::runtime_error("epoch_tiered_vector: too many readers");
+        }
+
+        // Writer only.
+        template <typename... Args>
+        T& emplace_back(Args&&... args){
+            if((sz&block_mask) == 0 && (sz>>BlockBits) == block_count) add_block();
+            T* slot = spine.load(std::memory_order_relaxed)[sz>>BlockBits] + (sz&block_mask);
+            alloc_traits::construct(alloc, slot, std::forward<Args>(args)...);
+            published.store(++sz, std::memory_order_release);
+            return *slot;
+        }
+
+        void push_back(const T& value){
+            emplace_back(value);
+        }
+
+        void push_back(T&& value){
+            emplace_back(move(value));
+        }
+
+        // Writer only. Sizes the spine and allocates the blocks for n elements
+        // up front, so appends below n never reallocate the spine.
+        void reserve(size_t n){
+            size_t needed = (n + block_mask) >> BlockBits;
+            if(needed > spine_cap) grow_spine(std::bit_ceil(needed));
+            while(block_count < needed) add_block();
+        }
+
+        // Writer only. Frees the retired spines no pinned reader can still be
+        // using. Runs after every spine growth; call it to catch up after a
+        // long pin.
+        void reclaim(){
+            uint64_t oldest = oldest_pinned();
+            std::erase_if(retired, [&](const retired_spine& r){
+                if(r.epoch >= oldest) return false;
+                deallocate_spine(r.slots, r.capacity);
+                return true;
+            });
+        }
+
+        // Not thread-safe: no reader may be active. Destroys the elements and
+        // keeps the blocks.
+        void clear(){
+            if constexpr (!is_trivially_destructible_v<T>){
+                T** slots = spine.load(std::memory_order_relaxed);
+                for(size_t i = 0; i < sz; ++i) alloc_traits::destroy(alloc, slots[i>>BlockBits] + (i&block_mask));
+            }
+            sz = 0;
+            published.store(0, std::memory_order_release);
+        }
+
+        // Readers: only inside a pin, and only for idx < size(). seq_cst so the
+        // load cannot move ahead of the pin's store (a plain load on x86).
+        const T& operator[](size_t idx) const {
+            return spine.load(std::memory_order_seq_cst)[idx>>BlockBits][idx&block_mask];
+        }
+
+        // Mutable access for the writer. Readers holding a non-const reference
+        // end up here too, so it loads the spine the same way.
+        T& operator[](size_t idx){
+            return spine.load(std::memory_order_seq_cst)[idx>>BlockBits][idx&block_mask];
+        }
+
+        size_t size() const {return published.load(std::memory_order_acquire);}
+        bool empty() const {return size() == 0;}
+        size_t retired_spines() const {return retired.size();}
+        allocator_type get_allocator() const {return alloc;}
+};
+
+}
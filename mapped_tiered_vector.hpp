@@ -0,0 +1,260 @@
+#pragma once
+#include "tiered_vector.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cppx {
+
+// tiered_vector whose blocks live in a file instead of on the heap, for
+// datasets larger than RAM. Linux/POSIX only, trivially copyable T only.
+//
+// File layout: one header page (geometry and size), then the blocks back to
+// back, each padded to a whole number of pages. Blocks are mapped in runs that
+// double in length, so growth only extends the file and maps the new tail (no
+// copying), and a large container needs O(log n) mappings rather than one per
+// block. The spine holds the mapped block addresses, so indexing is the usual
+// shift and mask. Reopening a file maps every existing block in one run and
+// refills the spine, O(blocks).
+//
+// Element bytes are the file's bytes: what you write is persisted by the page
+// cache, and flush() forces it to disk. Errors are thrown as
+// std::system_error: OS failures with their errno, and an existing file that is
+// not a valid tiered_vector file of this geometry (short, truncated, wrong
+// magic, element size or block size) with EINVAL. Only an empty file is
+// initialized; nothing else is ever overwritten.
+template <typename T, size_t BlockBits = default_block_bits<T>()>
+class mapped_tiered_vector{
+    static_assert(BlockBits > 0 && BlockBits < 32, "BlockBits must be in [1, 31]");
+    static_assert(is_trivially_copyable_v<T>, "mapped_tiered_vector stores raw bytes; T must be trivially copyable");
+
+    public:
+        static constexpr size_t block_bits = BlockBits;
+        static constexpr size_t block_size = size_t(1) << BlockBits;
+        static constexpr size_t block_mask = block_size - 1;
+
+        enum class access_pattern{normal, sequential, random};
+
+    private:
+        struct file_header{
+            char magic[8];
+            uint32_t version;
+            uint32_t block_bits;
+            uint64_t element_size;
+            uint64_t size;
+            uint64_t blocks;
+        };
+
+        struct mapped_run{
+            void* addr;
+            size_t bytes;
+        };
+
+        static constexpr char magic[8] = {'C','P','P','X','T','V','M','1'};
+
+        int fd;
+        size_t page;
+        size_t stride;
+        file_header* header;
+        std::vector<T*> spine;
+        std::vector<mapped_run> runs;
+        size_t sz;
+        access_pattern pattern;
+
+        [[noreturn]] static void fail(const char* what, int err = errno){
+            throw std::system_error(err, std::generic_category(), what);
+        }
+
+        void* map(size_t offset, size_t bytes){
+            void* addr = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(offset));
+            if(addr == MAP_FAILED) fail("mmap");
+            return addr;
+        }
+
+        void advise_run(const mapped_run& run){
+            int advice = pattern == access_pattern::sequential ? MADV_SEQUENTIAL :
+                         pattern == access_pattern::random ? MADV_RANDOM : MADV_NORMAL;
+            ::madvise(run.addr, run.bytes, advice);
+        }
+
+        // Maps blocks [spine.size(), spine.size() + n) from the file as one run.
+        void map_blocks(size_t n){
+            size_t first = spine.size();
+            mapped_run run{map(page + first * stride, n * stride), n * stride};
+            runs.push_back(run);
+            advise_run(run);
+            char* base = static_cast<char*>(run.addr);
+            for(size_t i = 0; i < n; ++i) spine.push_back(reinterpret_cast<T*>(base + i * stride));
+        }
+
+        // Extends the file (it reads back as zeros) and maps the new blocks. The
+        // run at least doubles the mapped block count to keep mappings few.
+        void ensure_blocks(size_t n){
+            size_t needed = (n + block_mask) >> BlockBits;
+            if(needed <= spine.size()) return;
+
+            size_t grow = std::max(needed - spine.size(), std::max<size_t>(spine.size(), 1));
+            size_t total = spine.size() + grow;
+            if(::ftruncate(fd, static_cast<off_t>(page + total * stride)) != 0) fail("ftruncate");
+            map_blocks(grow);
+            header->blocks = total;
+        }
+
+        void attach(){
+            struct stat st;
+            if(::fstat(fd, &st) != 0) fail("fstat");
+            size_t file_bytes = static_cast<size_t>(st.st_size);
+
+            if(file_bytes == 0){
+                if(::ftruncate(fd, static_cast<off_t>(page)) != 0) fail("ftruncate");
+                header = static_cast<file_header*>(map(0, page));
+                std::memcpy(header->magic, magic, sizeof(magic));
+                header->version = 1;
+                header->block_bits = BlockBits;
+                header->element_size = sizeof(T);
+                header->size = 0;
+                header->blocks = 0;
+                return;
+            }
+
+            if(file_bytes < page) fail("mapped_tiered_vector: file is shorter than its header", EINVAL);
+            header = static_cast<file_header*>(map(0, page));
+            if(std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != 1){
+                fail("mapped_tiered_vector: not a tiered_vector file", EINVAL);
+            }
+            if(header->block_bits != BlockBits || header->element_size != sizeof(T)){
+                fail("mapped_tiered_vector: file has a different block geometry", EINVAL);
+            }
+            // Mapping past the end of the file would fault on first access.
+            if(header->blocks > (file_bytes - page) / stride){
+                fail("mapped_tiered_vector: file is shorter than its block count", EINVAL);
+            }
+            if(header->size > (header->blocks << BlockBits)){
+                fail("mapped_tiered_vector: size exceeds the blocks in the file", EINVAL);
+            }
+            if(header->blocks > 0) map_blocks(header->blocks);
+            sz = header->size;
+        }
+
+        void release(){
+            for(const mapped_run& run : runs) ::munmap(run.addr, run.bytes);
+            if(header != nullptr) ::munmap(header, page);
+            if(fd >= 0) ::close(fd);
+            runs.clear();
+            spine.clear();
+            header = nullptr;
+            fd = -1;
+        }
+
+    public:
+        using value_type = T;
+
+        // Opens path, creating it if needed. An existing file is reattached: its
+        // elements are there again with no reading or copying.
+        explicit mapped_tiered_vector(const std::string& path, access_pattern hint = access_pattern::normal) :
+            fd(-1), page(static_cast<size_t>(::sysconf(_SC_PAGESIZE))), header(nullptr), sz(0), pattern(hint)
+        {
+            stride = (block_size * sizeof(T) + page - 1) / page * page;
+            fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if(fd < 0) fail("open");
+            try{
+                attach();
+            }
+            catch(...){
+                release();
+                throw;
+            }
+        }
+
+        mapped_tiered_vector(const mapped_tiered_vector&) = delete;
+        mapped_tiered_vector& operator= (const mapped_tiered_vector&) = delete;
+
+        ~mapped_tiered_vector(){
+            release();
+        }
+
+        // madvise for every mapped block, and for blocks mapped later on.
+        void advise(access_pattern hint){
+            pattern = hint;
+            for(const mapped_run& run : runs) advise_run(run);
+        }
+
+        // Writes dirty pages back to the file and waits for the I/O.
+        void flush(){
+            for(const mapped_run& run : runs){
+                if(::msync(run.addr, run.bytes, MS_SYNC) != 0) fail("msync");
+            }
+            if(::msync(header, page, MS_SYNC) != 0) fail("msync");
+        }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args){
+            if((sz&block_mask) == 0) ensure_blocks(sz + 1);
+            T* slot = spine[sz>>BlockBits] + (sz&block_mask);
+            ::new (static_cast<void*>(slot)) T(std::forward<Args>(args)...);
+            header->size = ++sz;
+            return *slot;
+        }
+
+        void push_back(const T& value){
+            emplace_back(value);
+        }
+
+        void pop_back(){
+            if(sz == 0) return;
+            header->size = --sz;
+        }
+
+        // Blocks past the end stay in the file, so shrinking frees no disk space.
+        void resize(size_t new_size, const T& value = T()){
+            ensure_blocks(new_size);
+            for(; sz < new_size; ++sz) spine[sz>>BlockBits][sz&block_mask] = value;
+            sz = new_size;
+            header->size = sz;
+        }
+
+        void reserve(size_t n){
+            ensure_blocks(n);
+        }
+
+        void clear(){
+            sz = 0;
+            header->size = 0;
+        }
+
+        T& operator[](size_t idx){
+            return spine[idx>>BlockBits][idx&block_mask];
+        }
+
+        const T& operator[](size_t idx) const {
+            return spine[idx>>BlockBits][idx&block_mask];
+        }
+
+        std::span<T> segment(size_t b){
+            return std::span<T>(spine[b], std::min(block_size, sz - (b<<BlockBits)));
+        }
+
+        std::span<const T> segment(size_t b) const {
+            return std::span<const T>(spine[b], std::min(block_size, sz - (b<<BlockBits)));
+        }
+
+        size_t segment_count() const {return (sz + block_mask) >> BlockBits;}
+
+        template <typename F>
+        void for_each_segment(F&& f){
+            for(size_t b = 0; b < segment_count(); ++b) f(segment(b));
+        }
+
+        template <typename F>
+        void for_each_segment(F&& f) const {
+            for(size_t b = 0; b < segment_count(); ++b) f(segment(b));
+        }
+
+        size_t size() const {return sz;}
+        size_t capacity() const {return spine.size()<<BlockBits;}
+        bool empty() const {return sz == 0;}
+        size_t mapping_count() const {return runs.size();}
+};
+
+}
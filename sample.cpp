@@ -1,5 +1,6 @@
 #include <bits/stdc++.h>
 #include "tiered_vector.hpp"
+#include "tiered_parallel.hpp"
 
 using namespace std;
 using namespace cppx;
@@ -68,6 +69,16 @@ int main() {
     cout << "After pop_back x1000: " << assigned.size() << endl;
 
 
+    cout << endl;
+
+    //Emplace Back (move-only type, constructed in place)
+    tiered_vector<unique_ptr<string>> emplace_tv;
+    for (int i = 0; i < 3; ++i) {
+        emplace_tv.emplace_back(make_unique<string>("item" + to_string(i)));
+    }
+    cout << "Emplace size: " << emplace_tv.size() << endl;
+    cout << "Emplace element check: " << *emplace_tv[2] << endl;
+
     cout << endl;
 
     //Iterator Test
@@ -99,7 +110,7 @@ int main() {
     //sorting test
     cout << "Sorting Test: " << endl;
     tiered_vector<int> sort_tv = {5, 3, 8, 1, 2, 7, 4, 6};
-    sort(sort_tv.begin(), sort_tv.end());
+    cppx::sort(sort_tv);
     for (auto& val : sort_tv) {
         cout << val << " ";
     }
@@ -0,0 +1,230 @@
+#pragma once
+#include "tiered_vector.hpp"
+
+namespace cppx {
+
+// tiered_vector with one reader/writer lock per block.
+//
+// Element access takes only the lock of the one block it touches, so threads
+// working on different blocks never wait for each other, and readers of the
+// same block share it. The block pointers and their locks live in a directory
+// of doubling segments (8, 8, 16, 32, ... slots) hung off a fixed array, like
+// concurrent_tiered_vector's spine: growing it only publishes new memory, so
+// readers find their block with two acquire loads and no shared lock.
+// resize/push_back serialize on a growth mutex that element access never takes,
+// and publish the new block pointers before the new size.
+//
+// Indices passed to read/write/update must be below a size() the caller has
+// observed; shrinking concurrently with access to the removed elements is a
+// race, as with any container.
+template <typename T, size_t BlockBits = default_block_bits<T>(), typename Allocator = std::allocator<T>>
+class segmented_lock_tiered_vector{
+    static_assert(BlockBits > 0 && BlockBits < 32, "BlockBits must be in [1, 31]");
+
+    private:
+        // Reader/writer lock on one word: the top bit marks a writer, the next
+        // one that a thread is blocked in atomic::wait, the rest count readers.
+        // Uncontended, each side is one CAS or fetch_add, several times cheaper
+        // than std::shared_mutex, and unlock only calls notify_all when someone
+        // is waiting. Readers are preferred: a writer waits until a block has no
+        // readers.
+        class block_lock{
+            static constexpr uint32_t writer = uint32_t(1) << 31;
+            static constexpr uint32_t waiting = uint32_t(1) << 30;
+            std::atomic<uint32_t> state{0};
+
+            // Marks the lock as waited on and blocks while it still reads s.
+            // Returns the state to retry with.
+            uint32_t wait(uint32_t s){
+                if(!(s & waiting) && !state.compare_exchange_weak(s, s | waiting, std::memory_order_relaxed)) return s;
+                state.wait(s | waiting, std::memory_order_relaxed);
+                return state.load(std::memory_order_relaxed);
+            }
+
+            public:
+                void lock(){
+                    uint32_t s = 0;
+                    while(true){
+                        // A writer taking a waited-on lock keeps the flag, so its
+                        // unlock still wakes the others.
+                        if((s & ~waiting) == 0){
+                            if(state.compare_exchange_weak(s, writer | s, std::memory_order_acquire, std::memory_order_relaxed)) return;
+                        }
+                        else s = wait(s);
+                    }
+                }
+
+                void unlock(){
+                    if(state.exchange(0, std::memory_order_release) & waiting) state.notify_all();
+                }
+
+                void lock_shared(){
+                    uint32_t s = state.load(std::memory_order_relaxed);
+                    while(true){
+                        if(!(s & writer)){
+                            if(state.compare_exchange_weak(s, s + 1, std::memory_order_acquire, std::memory_order_relaxed)) return;
+                        }
+                        else s = wait(s);
+                    }
+                }
+
+                void unlock_shared(){
+                    uint32_t s = state.fetch_sub(1, std::memory_order_release) - 1;
+                    if(s == waiting && state.compare_exchange_strong(s, 0, std::memory_order_relaxed)) state.notify_all();
+                }
+        };
+
+        // One lock per block, padded so neighbouring blocks don't share a line.
+        struct alignas(64) block_slot{
+            block_lock mtx;
+            std::atomic<T*> block{nullptr};
+        };
+
+        using alloc_traits   = std::allocator_traits<Allocator>;
+        using slot_allocator = typename alloc_traits::template rebind_alloc<block_slot>;
+        using slot_traits    = std::allocator_traits<slot_allocator>;
+
+        static constexpr size_t first_segment_bits = 3;
+        static constexpr size_t max_segments = 65 - BlockBits - first_segment_bits;
+
+        tiered_vector<T, BlockBits, Allocator> data;
+        std::atomic<block_slot*> directory[max_segments];
+        std::atomic<size_t> sz;
+        // Blocks whose pointer is in the directory. Guarded by grow_mtx.
+        size_t published;
+        std::mutex grow_mtx;
+
+        // Block b lives in segment bit_width(b >> first_segment_bits); segment 0
+        // and 1 hold 8 slots each, every later segment twice the previous one.
+        static size_t segment_of(size_t b){return std::bit_width(b >> first_segment_bits);}
+        static size_t segment_base(size_t k){return k == 0 ? 0 : size_t(1) << (first_segment_bits + k - 1);}
+        static size_t segment_slots(size_t k){return size_t(1) << (first_segment_bits + (k == 0 ? 0 : k - 1));}
+
+        block_slot& slot_of(size_t b) const {
+            size_t k = segment_of(b);
+            return directory[k].load(std::memory_order_acquire)[b - segment_base(k)];
+        }
+
+        // Caller holds grow_mtx. Allocates the directory segments for the first
+        // n elements before data grows, so publishing afterwards cannot throw.
+        void reserve_slots(size_t n){
+            size_t blocks = (n + block_size - 1) >> BlockBits;
+            for(size_t k = 0; k < max_segments && segment_base(k) < blocks; ++k){
+                if(directory[k].load(std::memory_order_relaxed) != nullptr) continue;
+
+                slot_allocator slot_alloc(data.get_allocator());
+                block_slot* fresh = slot_traits::allocate(slot_alloc, segment_slots(k));
+                for(size_t i = 0; i < segment_slots(k); ++i) ::new (static_cast<void*>(fresh + i)) block_slot;
+                directory[k].store(fresh, std::memory_order_release);
+            }
+        }
+
+        // Caller holds grow_mtx. Blocks below both the old and the new count
+        // keep their address; the ones after may be new or, after a shrink,
+        // reused from the block cache, so their pointers are stored again.
+        void publish(){
+            size_t blocks = data.segment_count();
+            published = std::min(published, blocks);
+            for(; published < blocks; ++published)
+                slot_of(published).block.store(&data[published << BlockBits], std::memory_order_release);
+            sz.store(data.size(), std::memory_order_release);
+        }
+
+        // Caller holds grow_mtx; n is the size g() grows data to. If g throws,
+        // whatever it already did to data is still published.
+        template <typename Grow>
+        void grow_locked(size_t n, Grow&& g){
+            reserve_slots(n);
+            try{
+                g();
+            }
+            catch(...){
+                publish();
+                throw;
+            }
+            publish();
+        }
+
+        T& element(block_slot& slot, size_t idx) const {
+            return slot.block.load(std::memory_order_acquire)[idx & block_mask];
+        }
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        static constexpr size_t block_bits = BlockBits;
+        static constexpr size_t block_size = size_t(1) << BlockBits;
+        static constexpr size_t block_mask = block_size - 1;
+
+        segmented_lock_tiered_vector() : segmented_lock_tiered_vector(Allocator()) {}
+
+        explicit segmented_lock_tiered_vector(const Allocator& alloc) : data(alloc), sz(0), published(0){
+            for(auto& seg : directory) seg.store(nullptr, std::memory_order_relaxed);
+        }
+
+        ~segmented_lock_tiered_vector(){
+            slot_allocator slot_alloc(data.get_allocator());
+            for(size_t k = 0; k < max_segments; ++k){
+                block_slot* seg = directory[k].load(std::memory_order_acquire);
+                if(seg == nullptr) continue;
+                for(size_t i = 0; i < segment_slots(k); ++i) seg[i].~block_slot();
+                slot_traits::deallocate(slot_alloc, seg, segment_slots(k));
+            }
+        }
+
+        segmented_lock_tiered_vector(const segmented_lock_tiered_vector&) = delete;
+        segmented_lock_tiered_vector& operator= (const segmented_lock_tiered_vector&) = delete;
+
+        T read(size_t idx) const {
+            block_slot& slot = slot_of(idx >> BlockBits);
+            std::shared_lock<block_lock> block(slot.mtx);
+            return element(slot, idx);
+        }
+
+        void write(size_t idx, const T& value){
+            block_slot& slot = slot_of(idx >> BlockBits);
+            std::unique_lock<block_lock> block(slot.mtx);
+            element(slot, idx) = value;
+        }
+
+        void write(size_t idx, T&& value){
+            block_slot& slot = slot_of(idx >> BlockBits);
+            std::unique_lock<block_lock> block(slot.mtx);
+            element(slot, idx) = move(value);
+        }
+
+        // Read-modify-write under the block's exclusive lock; returns fn(element).
+        template <typename F>
+        decltype(auto) update(size_t idx, F&& fn){
+            block_slot& slot = slot_of(idx >> BlockBits);
+            std::unique_lock<block_lock> block(slot.mtx);
+            return std::invoke(std::forward<F>(fn), element(slot, idx));
+        }
+
+        void resize(size_t n){
+            std::lock_guard<std::mutex> lock(grow_mtx);
+            grow_locked(n, [&]{ data.resize(n); });
+        }
+
+        void resize(size_t n, const T& value){
+            std::lock_guard<std::mutex> lock(grow_mtx);
+            grow_locked(n, [&]{ data.resize(n, value); });
+        }
+
+        void push_back(const T& value){
+            std::lock_guard<std::mutex> lock(grow_mtx);
+            grow_locked(data.size() + 1, [&]{ data.push_back(value); });
+        }
+
+        void push_back(T&& value){
+            std::lock_guard<std::mutex> lock(grow_mtx);
+            grow_locked(data.size() + 1, [&]{ data.push_back(move(value)); });
+        }
+
+        size_t size() const {return sz.load(std::memory_order_acquire);}
+
+        bool empty() const {return size() == 0;}
+        allocator_type get_allocator() const {return data.get_allocator();}
+};
+
+}
@@ -0,0 +1,188 @@
+#pragma once
+#include "tiered_vector.hpp"
+
+namespace cppx {
+
+// Index-addressed array (ID -> record) for huge, mostly empty index spaces.
+//
+// A block that has never been written is absent: its spine slot points at one
+// shared, read-only block filled with the default value, so resize(n) only
+// grows the spine and const reads need no branch. The first write to an absent
+// block materializes it as a fresh block of default values. set() and the
+// non-const operator[] count as writes, so read through get() or a const
+// reference, which never allocate. for_each_present visits only materialized
+// blocks.
+//
+// Materialized blocks hold block_size constructed elements, so T must be copy
+// constructible. Shrinking frees whole blocks past the end and resets the tail
+// of a partial block to the default value, so growing again reads defaults.
+template <typename T, size_t BlockBits = default_block_bits<T>(), typename Allocator = std::allocator<T>>
+class sparse_tiered_vector{
+    static_assert(BlockBits > 0 && BlockBits < 32, "BlockBits must be in [1, 31]");
+
+    public:
+        static constexpr size_t block_bits = BlockBits;
+        static constexpr size_t block_size = size_t(1) << BlockBits;
+        static constexpr size_t block_mask = block_size - 1;
+
+    private:
+        using alloc_traits    = std::allocator_traits<Allocator>;
+        using spine_allocator = typename alloc_traits::template rebind_alloc<T*>;
+
+        static_assert(is_same_v<typename alloc_traits::pointer, T*>, "fancy pointers are not supported");
+
+        std::vector<T*, spine_allocator> spine;
+        T* default_block;
+        size_t sz;
+        size_t present;
+        [[no_unique_address]] Allocator alloc;
+
+        // A block of block_size copies of value.
+        T* make_block(const T& value){
+            T* blk = alloc_traits::allocate(alloc, block_size);
+            size_t i = 0;
+            try{
+                for(; i < block_size; ++i) alloc_traits::construct(alloc, blk + i, value);
+            }
+            catch(...){
+                while(i > 0) alloc_traits::destroy(alloc, blk + --i);
+                alloc_traits::deallocate(alloc, blk, block_size);
+                throw;
+            }
+            return blk;
+        }
+
+        void free_block(T* blk){
+            for(size_t i = 0; i < block_size; ++i) alloc_traits::destroy(alloc, blk + i);
+            alloc_traits::deallocate(alloc, blk, block_size);
+        }
+
+        T* writable(size_t b){
+            T*& blk = spine[b];
+            if(blk == default_block){
+                blk = make_block(*default_block);
+                present++;
+            }
+            return blk;
+        }
+
+        void release_blocks(size_t first){
+            for(size_t b = first; b < spine.size(); ++b){
+                if(spine[b] != default_block){
+                    free_block(spine[b]);
+                    present--;
+                }
+            }
+            spine.resize(first);
+        }
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+
+        explicit sparse_tiered_vector(size_t n = 0, const T& default_value = T(), const Allocator& a = Allocator()) :
+            spine(spine_allocator(a)), default_block(nullptr), sz(0), present(0), alloc(a)
+        {
+            default_block = make_block(default_value);
+            try{
+                resize(n);
+            }
+            catch(...){
+                free_block(default_block);
+                throw;
+            }
+        }
+
+        sparse_tiered_vector(const sparse_tiered_vector&) = delete;
+        sparse_tiered_vector& operator= (const sparse_tiered_vector&) = delete;
+
+        ~sparse_tiered_vector(){
+            release_blocks(0);
+            free_block(default_block);
+        }
+
+        // O(n / block_size): new blocks start absent.
+        void resize(size_t new_size){
+            size_t blocks = (new_size + block_mask) >> BlockBits;
+            if(new_size < sz){
+                release_blocks(blocks);
+                if((new_size&block_mask) != 0 && spine.back() != default_block){
+                    T* blk = spine.back();
+                    for(size_t i = new_size&block_mask; i < block_size; ++i) blk[i] = *default_block;
+                }
+            }
+            else{
+                spine.resize(blocks, default_block);
+            }
+            sz = new_size;
+        }
+
+        void clear(){
+            release_blocks(0);
+            sz = 0;
+        }
+
+        // Const reads of absent blocks return the shared default value.
+        const T& operator[](size_t idx) const {
+            return spine[idx>>BlockBits][idx&block_mask];
+        }
+
+        const T& get(size_t idx) const {
+            return (*this)[idx];
+        }
+
+        // Materializes idx's block.
+        T& operator[](size_t idx){
+            return writable(idx>>BlockBits)[idx&block_mask];
+        }
+
+        void set(size_t idx, const T& value){
+            writable(idx>>BlockBits)[idx&block_mask] = value;
+        }
+
+        void set(size_t idx, T&& value){
+            writable(idx>>BlockBits)[idx&block_mask] = move(value);
+        }
+
+        bool is_present(size_t idx) const {
+            return spine[idx>>BlockBits] != default_block;
+        }
+
+        const T& default_value() const {return *default_block;}
+
+        // Calls f(index, element) for every index below size() that lies in a
+        // materialized block, in index order. Absent blocks cost one compare.
+        template <typename F>
+        void for_each_present(F&& f){
+            for(size_t b = 0; b < spine.size(); ++b){
+                if(spine[b] == default_block) continue;
+                size_t base = b<<BlockBits;
+                size_t n = std::min(block_size, sz - base);
+                for(size_t i = 0; i < n; ++i) f(base + i, spine[b][i]);
+            }
+        }
+
+        template <typename F>
+        void for_each_present(F&& f) const {
+            for(size_t b = 0; b < spine.size(); ++b){
+                if(spine[b] == default_block) continue;
+                size_t base = b<<BlockBits;
+                size_t n = std::min(block_size, sz - base);
+                for(size_t i = 0; i < n; ++i) f(base + i, std::as_const(spine[b][i]));
+            }
+        }
+
+        size_t size() const {return sz;}
+        bool empty() const {return sz == 0;}
+        size_t block_count() const {return spine.size();}
+        size_t present_block_count() const {return present;}
+
+        // Bytes held: spine, materialized blocks and the shared default block.
+        size_t memory_usage() const {
+            return spine.capacity() * sizeof(T*) + (present + 1) * block_size * sizeof(T);
+        }
+
+        allocator_type get_allocator() const {return alloc;}
+};
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdlib>
+#include <iostream>
+
+// assert() that stays on in Release builds. Each test is a program that
+// returns 0 when every CHECK holds; ctest runs them all.
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK failed: " #cond "\n"; \
+            std::exit(1); \
+        } \
+    } while (0)
+
+// CHECK that expr throws an exception of type E.
+#define CHECK_THROWS(E, expr) \
+    do { \
+        bool thrown_ = false; \
+        try { expr; } catch (const E&) { thrown_ = true; } \
+        CHECK(thrown_); \
+    } while (0)
@@ -0,0 +1,115 @@
+#include "../circular_tiered_vector.hpp"
+#include "check.hpp"
+#include <deque>
+#include <random>
+using namespace std;
+using namespace cppx;
+
+// Counts live objects so a leaked or doubly destroyed slot shows up.
+struct Tracked {
+    static inline long live = 0;
+    string s;
+    Tracked(int v) : s(to_string(v)) {++live;}
+    Tracked(const Tracked& o) : s(o.s) {++live;}
+    Tracked(Tracked&& o) noexcept : s(move(o.s)) {++live;}
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) noexcept = default;
+    ~Tracked() {--live;}
+};
+
+// Four slots per block, so rings wrap and blocks fill after a few operations.
+using CTV = circular_tiered_vector<Tracked, 2>;
+constexpr size_t B = CTV::block_size;
+
+void check_equal(const CTV& v, const deque<string>& ref) {
+    CHECK(v.size() == ref.size());
+    for (size_t i = 0; i < ref.size(); ++i) CHECK(v[i].s == ref[i]);
+    CHECK(size_t(Tracked::live) == ref.size());
+}
+
+void pop_back_on_empty_is_a_no_op() {
+    CTV v;
+    v.pop_back();
+    CHECK(v.empty());
+    v.push_back(1);
+    v.pop_back();
+    v.pop_back();
+    CHECK(v.empty() && Tracked::live == 0);
+}
+
+// Inserts and erases at the first and last slot of every block, at the front
+// and at the end, with rings rotated by earlier operations.
+void block_boundaries() {
+    CTV v;
+    deque<string> ref;
+    for (int i = 0; i < 5 * int(B); ++i) {
+        v.push_back(i);
+        ref.push_back(to_string(i));
+    }
+    int next = 1000;
+    for (int round = 0; round < 3; ++round) {
+        for (size_t b = 0; b <= v.size() / B; ++b) {
+            for (size_t idx : {b * B, b * B + B - 1}) {
+                if (idx > v.size()) continue;
+                v.insert(idx, Tracked(next));
+                ref.insert(ref.begin() + idx, to_string(next++));
+                check_equal(v, ref);
+            }
+        }
+        for (size_t b = v.size() / B + 1; b-- > 0;) {
+            for (size_t idx : {b * B + B - 1, b * B}) {
+                if (idx >= v.size()) continue;
+                v.erase(idx);
+                ref.erase(ref.begin() + idx);
+                check_equal(v, ref);
+            }
+        }
+    }
+    v.insert(v.size(), Tracked(-1));
+    ref.push_back("-1");
+    v.erase(v.size() - 1);
+    ref.pop_back();
+    v.erase(size_t(0));
+    ref.pop_front();
+    check_equal(v, ref);
+}
+
+void random_against_deque() {
+    mt19937 rng(7);
+    CTV v;
+    deque<string> ref;
+    for (int step = 0; step < 20000; ++step) {
+        unsigned op = rng() % 10;
+        if (op < 5 || ref.empty()) {
+            size_t idx = rng() % (ref.size() + 1);
+            v.insert(idx, Tracked(step));
+            ref.insert(ref.begin() + idx, to_string(step));
+        } else if (op < 9) {
+            size_t idx = rng() % ref.size();
+            v.erase(idx);
+            ref.erase(ref.begin() + idx);
+        } else {
+            v.pop_back();
+            ref.pop_back();
+        }
+        if (step % 97 == 0) check_equal(v, ref);
+    }
+    check_equal(v, ref);
+
+    // The iterator overloads go through the same paths.
+    auto it = v.insert(v.cbegin() + 1, Tracked(-2));
+    ref.insert(ref.begin() + 1, "-2");
+    CHECK(it->s == "-2");
+    it = v.erase(v.cbegin() + 1);
+    ref.erase(ref.begin() + 1);
+    CHECK(it->s == ref[1]);
+    check_equal(v, ref);
+}
+
+int main() {
+    pop_back_on_empty_is_a_no_op();
+    block_boundaries();
+    random_against_deque();
+    CHECK(Tracked::live == 0);
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include "../compressed_tiered_vector.hpp"
+#include "check.hpp"
+#include <random>
+using namespace std;
+using namespace cppx;
+
+// Sixteen elements per block and a two-block cache, so tests seal many blocks
+// and evict decoded ones.
+template <typename T>
+using CTV = compressed_tiered_vector<T, 4>;
+
+template <typename T>
+void check_equal(const CTV<T>& v, const vector<T>& ref) {
+    CHECK(v.size() == ref.size());
+    CHECK(v.segment_count() == (ref.size() + 15) / 16);
+    for (size_t i = 0; i < ref.size(); ++i) CHECK(v[i] == ref[i]);
+    for (size_t i = ref.size(); i-- > 0;) CHECK(v[i] == ref[i]);
+    CHECK(equal(v.begin(), v.end(), ref.begin(), ref.end()));
+
+    size_t i = 0;
+    v.for_each_segment([&](span<const T> seg) {
+        for (T x : seg) CHECK(x == ref[i++]);
+    });
+    CHECK(i == ref.size());
+}
+
+template <typename T>
+CTV<T> build(const vector<T>& ref) {
+    CTV<T> v(2);
+    for (T x : ref) v.push_back(x);
+    return v;
+}
+
+// Each dataset round-trips, then set() rewrites random elements, including
+// ones that widen a block or switch its codec.
+template <typename T>
+void round_trip(const vector<T>& ref_in, mt19937& rng) {
+    vector<T> ref = ref_in;
+    CTV<T> v = build(ref);
+    check_equal(v, ref);
+
+    for (int k = 0; k < 200 && !ref.empty(); ++k) {
+        size_t i = rng() % ref.size();
+        T x = k % 3 == 0 ? numeric_limits<T>::min() : k % 3 == 1 ? numeric_limits<T>::max() : T(rng());
+        v.set(i, x);
+        ref[i] = x;
+        CHECK(v[i] == x);
+    }
+    check_equal(v, ref);
+}
+
+void edge_values() {
+    mt19937 rng(3);
+    using L = numeric_limits<int64_t>;
+
+    vector<int64_t> all_min(64, L::min()), all_max(64, L::max()), extremes, steps, randoms;
+    for (int i = 0; i < 70; ++i) extremes.push_back(i % 2 ? L::max() : L::min());
+    for (int i = 0; i < 70; ++i) steps.push_back(L::max() - 5 * int64_t(i));
+    for (int i = 0; i < 70; ++i) randoms.push_back(int64_t(uint64_t(rng()) << 32 | rng()));
+
+    for (const auto* data : {&all_min, &all_max, &extremes, &steps, &randoms}) round_trip(*data, rng);
+
+    // The codecs pick the narrowest encoding; alternating extremes differ by
+    // +1 and -1 modulo 2^64, so they pack as 2-bit deltas.
+    CTV<int64_t> equal_block = build(all_min);
+    CHECK(equal_block.block_width(0) == 0);
+    CTV<int64_t> step_block = build(steps);
+    CHECK(step_block.block_codec(0) == CTV<int64_t>::codec::delta && step_block.block_width(0) == 0);
+    CTV<int64_t> extreme_block = build(extremes);
+    CHECK(extreme_block.block_codec(0) == CTV<int64_t>::codec::delta && extreme_block.block_width(0) == 2);
+
+    vector<uint64_t> wrap;
+    for (int i = 0; i < 40; ++i) wrap.push_back(numeric_limits<uint64_t>::max() - 3 + i);
+    round_trip(wrap, rng);
+}
+
+void small_types() {
+    mt19937 rng(5);
+    vector<uint8_t> bytes, saw;
+    for (int i = 0; i < 100; ++i) bytes.push_back(uint8_t(rng()));
+    for (int i = 0; i < 100; ++i) saw.push_back(uint8_t(i * 37));
+    round_trip(bytes, rng);
+    round_trip(saw, rng);
+
+    vector<int8_t> signed_bytes;
+    for (int i = 0; i < 50; ++i) signed_bytes.push_back(int8_t(i % 2 ? -128 : 127));
+    round_trip(signed_bytes, rng);
+
+    vector<int32_t> ints;
+    for (int i = 0; i < 33; ++i) ints.push_back(i * 1000 - 16000);
+    round_trip(ints, rng);
+}
+
+// Sizes on and around block boundaries, so the plain tail is empty, partly
+// filled and one short of sealing.
+void partial_last_block() {
+    mt19937 rng(9);
+    for (size_t n : {0, 1, 15, 16, 17, 31, 32, 47}) {
+        vector<int64_t> ref;
+        for (size_t i = 0; i < n; ++i) ref.push_back(int64_t(rng()) - int64_t(rng()));
+        round_trip(ref, rng);
+    }
+    CTV<int> v;
+    for (int i = 0; i < 20; ++i) v.push_back(i);
+    v.clear();
+    CHECK(v.empty() && v.segment_count() == 0);
+    v.push_back(7);
+    CHECK(v[0] == 7 && v.back() == 7);
+}
+
+int main() {
+    edge_values();
+    small_types();
+    partial_last_block();
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../concurrent_tiered_vector.hpp"
+#include "check.hpp"
+using namespace std;
+using namespace cppx;
+
+atomic<long> live{0};
+
+// Throws when constructed from a multiple of 7; counts live objects, so a
+// destroy of a slot that never held one shows up as a negative count.
+struct Fragile {
+    int value;
+    Fragile(int v) : value(v) {
+        if (v % 7 == 0) throw runtime_error("fragile");
+        ++live;
+    }
+    Fragile(const Fragile& o) : Fragile(o.value) {}
+    ~Fragile() { --live; }
+};
+
+void throwing_emplace() {
+    {
+        concurrent_tiered_vector<Fragile, 3> v;
+        size_t thrown = 0;
+        for (int i = 1; i <= 1000; ++i) {
+            try {
+                v.emplace_back(i);
+            } catch (const runtime_error&) {
+                ++thrown;
+            }
+        }
+        CHECK(thrown == 1000 / 7);
+        CHECK(v.size() == 1000);
+        CHECK(live == 1000 - (long)thrown);
+
+        v.clear();
+        CHECK(live == 0);
+        v.emplace_back(1);
+        CHECK(live == 1);
+    }
+    CHECK(live == 0);
+}
+
+void throwing_grow_by() {
+    {
+        concurrent_tiered_vector<Fragile, 3> v;
+        vector<int> src = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+        CHECK_THROWS(runtime_error, v.grow_by(src.begin(), src.end()));
+        CHECK(v.size() == 10);
+        CHECK(live == 6);
+        v.grow_by(src.begin(), src.begin() + 3);
+        CHECK(live == 9);
+    }
+    CHECK(live == 0);
+}
+
+void concurrent_throws() {
+    {
+        concurrent_tiered_vector<Fragile, 4> v;
+        vector<thread> pool;
+        for (int t = 0; t < 4; ++t) {
+            pool.emplace_back([&, t] {
+                for (int i = t; i < 40000; i += 4) {
+                    try {
+                        v.emplace_back(i);
+                    } catch (const runtime_error&) {
+                    }
+                }
+            });
+        }
+        for (thread& th : pool) th.join();
+        CHECK(v.size() == 40000);
+        CHECK(live == 40000 - (40000 + 6) / 7);
+    }
+    CHECK(live == 0);
+}
+
+int main() {
+    throwing_emplace();
+    throwing_grow_by();
+    concurrent_throws();
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "../cow_tiered_vector.hpp"
+#include "check.hpp"
+using namespace std;
+using namespace cppx;
+
+using Cow = cow_tiered_vector<int, 4>;
+
+Cow make(int n) {
+    Cow v;
+    for (int i = 0; i < n; ++i) v.push_back(i);
+    return v;
+}
+
+// push_back and const reads hand out no mutable handle, so a snapshot shares
+// every block; access taken after it unshares only the blocks it touches.
+void writes_after_snapshot_unshare() {
+    Cow v = make(100);
+    CHECK(as_const(v)[50] == 50);
+    Cow snap = v.snapshot();
+    CHECK(v.shared_block_count() == v.segment_count());
+
+    v[3] = -3;
+    *(v.begin() + 40) = -40;
+    CHECK(v[3] == -3 && v[40] == -40);
+    CHECK(snap[3] == 3 && snap[40] == 40);
+    CHECK(v.shared_block_count() == v.segment_count() - 2);
+}
+
+// A reference, iterator or span kept across snapshot() pins its block, so the
+// snapshot gets its own copy and never sees writes through the handle.
+void stale_handles_do_not_reach_the_snapshot() {
+    Cow v = make(100);
+    int& ref = v[5];
+    auto it = v.begin() + 70;
+    span<int> seg = v.segment(3);
+    int& last = v.emplace_back(100);
+
+    Cow snap = v.snapshot();
+    Cow copy(v);
+    ref = -5;
+    *it = -70;
+    seg[1] = -49;
+    last = -100;
+    CHECK(v[5] == -5 && v[70] == -70 && v[49] == -49 && v[100] == -100);
+    for (const Cow* s : {&snap, &copy}) {
+        CHECK((*s)[5] == 5);
+        CHECK((*s)[70] == 70);
+        CHECK((*s)[49] == 49);
+        CHECK((*s)[100] == 100);
+    }
+
+    // The pinned blocks were copied; the untouched ones are still shared.
+    CHECK(v.shared_block_count() < v.segment_count());
+    CHECK(as_const(snap)[20] == 20 && &as_const(snap)[20] == &as_const(v)[20]);
+}
+
+int main() {
+    writes_after_snapshot_unshare();
+    stale_handles_do_not_reach_the_snapshot();
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include "../tiered_fifo.hpp"
+#include "check.hpp"
+#include <queue>
+#include <random>
+using namespace std;
+using namespace cppx;
+
+// Four slots per block, so the ring spine wraps after a few dozen pushes.
+using Fifo = tiered_fifo<string, 2>;
+constexpr size_t B = Fifo::block_size;
+
+void check_equal(Fifo& f, queue<string> ref) {
+    CHECK(f.size() == ref.size());
+    if (ref.empty()) return;
+    CHECK(f.front() == ref.front() && f.back() == ref.back());
+
+    size_t i = 0;
+    f.for_each_segment([&](span<string> seg) {
+        CHECK(!seg.empty());
+        for (const string& s : seg) CHECK(s == f[i++]);
+    });
+    CHECK(i == ref.size());
+    for (i = 0; !ref.empty(); ++i, ref.pop()) CHECK(f[i] == ref.front());
+}
+
+// A full window evicts its oldest element on every push; the ring wraps many
+// times, and once warm neither end allocates.
+void push_past_max(size_t max) {
+    Fifo f(max);
+    queue<string> ref;
+    size_t warm_misses = 0;
+    for (size_t step = 0; step < 40 * max + 50; ++step) {
+        string s = to_string(step);
+        f.push_back(s);
+        ref.push(s);
+        if (ref.size() > max) ref.pop();
+        if (step % 7 == 0) check_equal(f, ref);
+        if (step == 4 * max + 4 * B) warm_misses = f.cache_stats().misses;
+    }
+    check_equal(f, ref);
+    CHECK(f.cache_stats().misses == warm_misses);
+    CHECK(f.cache_stats().cached <= 2);
+}
+
+// Random pushes and pops keep the head off block boundaries, and emptying
+// the window resets it.
+void random_against_queue(size_t max) {
+    mt19937 rng(static_cast<unsigned>(max));
+    Fifo f(max);
+    queue<string> ref;
+    for (int step = 0; step < 20000; ++step) {
+        if (rng() % 3 != 0) {
+            string s = to_string(step);
+            f.push_back(s);
+            ref.push(s);
+            if (ref.size() > max) ref.pop();
+        } else {
+            f.pop_front();
+            if (!ref.empty()) ref.pop();
+        }
+        if (step % 13 == 0) check_equal(f, ref);
+    }
+    check_equal(f, ref);
+    f.clear();
+    check_equal(f, {});
+    f.pop_front();
+    f.push_back("x");
+    CHECK(f.size() == 1 && f.front() == "x");
+}
+
+int main() {
+    for (size_t max : {size_t(1), B - 1, B, B + 1, 3 * B + 2, 50 * B}) {
+        push_past_max(max);
+        random_against_queue(max);
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include "../tiered_vector.hpp"
+#include "check.hpp"
+#include <deque>
+#include <random>
+using namespace std;
+using namespace cppx;
+
+// Four slots per block, so the front offset crosses block boundaries often.
+using TV = tiered_vector<string, 2>;
+constexpr size_t B = TV::block_size;
+
+void check_equal(TV& v, const deque<string>& ref) {
+    CHECK(v.size() == ref.size());
+    for (size_t i = 0; i < ref.size(); ++i) CHECK(v[i] == ref[i]);
+    CHECK(equal(v.begin(), v.end(), ref.begin(), ref.end()));
+
+    size_t i = 0, b = 0;
+    for (span<string> seg : v.segments()) {
+        CHECK(!seg.empty() && v.segment_offset(b++) == i);
+        for (const string& s : seg) CHECK(s == ref[i++]);
+    }
+    CHECK(i == ref.size());
+    if (!ref.empty()) CHECK(v.front() == ref.front() && v.back() == ref.back());
+}
+
+// Walks the front offset across several block boundaries in both directions,
+// with the back fixed, and checks references stay put while it does.
+void front_offset_crosses_blocks() {
+    TV v;
+    deque<string> ref;
+    for (int i = 0; i < 3; ++i) {
+        v.push_back(to_string(i));
+        ref.push_back(to_string(i));
+    }
+    string* anchor = &v[1];
+    for (int i = 0; i < 3 * int(B) + 1; ++i) {
+        v.push_front(to_string(-1 - i));
+        ref.push_front(to_string(-1 - i));
+        check_equal(v, ref);
+    }
+    CHECK(anchor == &v[ref.size() - 2] && *anchor == "1");
+    for (int i = 0; i < 3 * int(B) + 2; ++i) {
+        v.pop_front();
+        ref.pop_front();
+        check_equal(v, ref);
+    }
+    CHECK(anchor == &v[0] && *anchor == "1");
+
+    // Empty with a non-zero offset, then refilled from both ends.
+    v.pop_front();
+    v.pop_front();
+    v.pop_front();
+    ref.clear();
+    CHECK(v.empty());
+    v.pop_front();
+    v.push_back("b");
+    v.push_front("a");
+    ref = {"a", "b"};
+    check_equal(v, ref);
+}
+
+void random_against_deque() {
+    mt19937 rng(11);
+    TV v;
+    deque<string> ref;
+    for (int step = 0; step < 30000; ++step) {
+        string s = to_string(step);
+        switch (rng() % 12) {
+            case 0: case 1: case 2:
+                v.push_front(s); ref.push_front(s); break;
+            case 3: case 4: case 5:
+                v.push_back(s); ref.push_back(s); break;
+            case 6: case 7:
+                v.pop_front(); if (!ref.empty()) ref.pop_front(); break;
+            case 8: case 9:
+                v.pop_back(); if (!ref.empty()) ref.pop_back(); break;
+            case 10: {
+                size_t n = rng() % (ref.size() + 2 * B + 1);
+                v.resize(n, s);
+                ref.resize(n, s);
+                break;
+            }
+            default:
+                v.shrink_to_fit();
+                CHECK(v.allocated_blocks() == v.segment_count());
+                break;
+        }
+        if (step % 37 == 0) check_equal(v, ref);
+    }
+    check_equal(v, ref);
+}
+
+// Copies and moves keep the front offset.
+void copy_and_move_with_offset() {
+    TV v;
+    deque<string> ref;
+    for (int i = 0; i < 10; ++i) {
+        v.push_back(to_string(i));
+        v.push_front(to_string(-i));
+        ref.push_back(to_string(i));
+        ref.push_front(to_string(-i));
+    }
+    TV copy = v;
+    check_equal(copy, ref);
+    TV moved = move(v);
+    check_equal(moved, ref);
+    moved.swap(copy);
+    check_equal(moved, ref);
+    check_equal(copy, ref);
+}
+
+int main() {
+    front_offset_crosses_blocks();
+    random_against_deque();
+    copy_and_move_with_offset();
+    return 0;
+}
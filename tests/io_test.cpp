@@ -0,0 +1,142 @@
+#include <cstdio>
+#include <fcntl.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+#include "../tiered_io.hpp"
+#include "check.hpp"
+using namespace std;
+using namespace cppx;
+
+using TV = tiered_vector<int, 8>;
+
+const string path = "io_test.bin";
+
+TV make(size_t n) {
+    TV tv;
+    for (size_t i = 0; i < n; ++i) tv.push_back((int)i);
+    return tv;
+}
+
+void save_file(const TV& tv) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    CHECK(fd >= 0);
+    save(tv, fd);
+    ::close(fd);
+}
+
+// Loads path into tv; returns the exception message, or "" on success.
+string load_file(TV& tv) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    CHECK(fd >= 0);
+    string error;
+    try {
+        load(tv, fd);
+    } catch (const runtime_error& e) {
+        error = e.what();
+    }
+    ::close(fd);
+    return error;
+}
+
+void set_size_field(uint64_t size) {
+    int fd = ::open(path.c_str(), O_WRONLY);
+    CHECK(::pwrite(fd, &size, sizeof(size), 24) == (ssize_t)sizeof(size));
+    ::close(fd);
+}
+
+void round_trip() {
+    TV tv = make(100000);
+    save_file(tv);
+    TV back;
+    CHECK(load_file(back).empty());
+    CHECK(back.size() == tv.size());
+    for (size_t i = 0; i < tv.size(); ++i) CHECK(back[i] == tv[i]);
+
+    stringstream ss;
+    save(tv, ss);
+    TV from_stream = make(3);
+    load(from_stream, ss);
+    CHECK(from_stream.size() == tv.size());
+    CHECK(from_stream[99999] == 99999);
+}
+
+// A truncated file or a count larger than the file is rejected before tv is
+// touched.
+void truncated_file() {
+    save_file(make(100000));
+    CHECK(::truncate(path.c_str(), 32 + 4 * 50000) == 0);
+    TV tv = make(10);
+    CHECK(!load_file(tv).empty());
+    CHECK(tv.size() == 10);
+
+    save_file(make(10));
+    set_size_field(uint64_t(1) << 60);
+    TV huge = make(10);
+    CHECK(!load_file(huge).empty());
+    CHECK(huge.size() == 10);
+}
+
+void empty_input_names_the_call() {
+    { FILE* f = fopen(path.c_str(), "w"); fclose(f); }
+    TV tv;
+    CHECK(load_file(tv).find("readv") != string::npos);
+}
+
+// A pipe has no length to check against: a header claiming 2^40 elements must
+// fail at end of input after allocating in bounded batches, not up front.
+void corrupt_count_from_pipe() {
+    int fds[2];
+    CHECK(::pipe(fds) == 0);
+    thread writer([&] {
+        io_detail::file_header h = io_detail::make_header(8, sizeof(int), size_t(1) << 40);
+        CHECK(::write(fds[1], &h, sizeof(h)) == (ssize_t)sizeof(h));
+        int data[1000] = {};
+        CHECK(::write(fds[1], data, sizeof(data)) == (ssize_t)sizeof(data));
+        ::close(fds[1]);
+    });
+    TV tv = make(5);
+    CHECK_THROWS(runtime_error, load(tv, fds[0]));
+    writer.join();
+    ::close(fds[0]);
+    CHECK(tv.empty());
+    CHECK(tv.memory_usage() < (size_t(8) << 20));
+}
+
+// Like a pipe: reports no position, so only batching bounds the load.
+struct unseekable_buf : stringbuf {
+    using stringbuf::stringbuf;
+    pos_type seekoff(off_type, ios::seekdir, ios::openmode) override { return pos_type(-1); }
+    pos_type seekpos(pos_type, ios::openmode) override { return pos_type(-1); }
+};
+
+void stream_errors() {
+    stringstream ss;
+    save(make(5000), ss);
+    string bytes = ss.str();
+
+    stringstream shorter(bytes.substr(0, bytes.size() - 8));
+    TV tv = make(10);
+    CHECK_THROWS(runtime_error, load(tv, shorter));
+    CHECK(tv.size() == 10);
+
+    unseekable_buf buf(bytes.substr(0, bytes.size() - 8));
+    istream piped(&buf);
+    CHECK_THROWS(runtime_error, load(tv, piped));
+    CHECK(tv.empty());
+
+    ostream broken(nullptr);
+    CHECK_THROWS(runtime_error, save(make(10), broken));
+}
+
+int main() {
+    round_trip();
+    truncated_file();
+    empty_input_names_the_call();
+    corrupt_count_from_pipe();
+    stream_errors();
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "../tiered_vector.hpp"
+#include "check.hpp"
+#include <deque>
+using namespace std;
+using namespace cppx;
+
+using TV = tiered_vector<int, 2>;
+constexpr int B = int(TV::block_size);
+
+// Every pair of positions, including end(), in a container whose front offset
+// puts block boundaries in the middle of the index range.
+void arithmetic(TV& v) {
+    int n = int(v.size());
+    for (int i = 0; i <= n; ++i) {
+        TV::iterator a = v.begin() + i;
+        CHECK(a - v.begin() == i && v.end() - a == n - i);
+        CHECK(a == i + v.begin() && a == v.end() - (n - i));
+        if (i < n) CHECK(*a == v[i] && a[0] == v[i]);
+
+        for (int j = 0; j <= n; ++j) {
+            TV::iterator b = a;
+            b += j - i;
+            CHECK(b == v.begin() + j && b - a == j - i);
+            CHECK((a < b) == (i < j) && (a <= b) == (i <= j));
+            CHECK((a > b) == (i > j) && (a >= b) == (i >= j));
+            CHECK((a != b) == (i != j));
+            if (j < n) CHECK(a[j - i] == v[j]);
+            b -= j - i;
+            CHECK(b == a);
+        }
+    }
+
+    // Stepping one at a time agrees with the random-access path both ways.
+    TV::iterator it = v.begin();
+    for (int i = 0; i < n; ++i) CHECK(it++ == v.begin() + i);
+    CHECK(it == v.end());
+    for (int i = n; i-- > 0;) CHECK(*--it == v[i]);
+    CHECK(it == v.begin());
+
+    TV::const_iterator c = v.begin();
+    CHECK(c == as_const(v).begin() && as_const(v).end() - c == n);
+    CHECK(equal(v.rbegin(), v.rend(), make_reverse_iterator(v.end()), make_reverse_iterator(v.begin())));
+}
+
+// end() must equal the iterator reached by walking off the last element, on
+// a block boundary with and without a spare block behind it.
+void end_on_block_boundary() {
+    TV v;
+    for (int i = 0; i < 2 * B; ++i) {
+        v.push_back(i);
+        TV::iterator walked = v.begin();
+        for (size_t k = 0; k < v.size(); ++k) ++walked;
+        CHECK(walked == v.end() && v.end() - v.begin() == i + 1);
+        CHECK(*--v.end() == i);
+    }
+
+    // assign() keeps the blocks, so the one after the boundary is allocated.
+    int data[3 * B];
+    iota(data, data + 3 * B, 0);
+    v.assign(data, 3 * B);
+    v.assign(data, B);
+    CHECK(v.allocated_blocks() > v.segment_count());
+    TV::iterator walked = v.begin();
+    for (int k = 0; k < B; ++k) ++walked;
+    CHECK(walked == v.end() && *--walked == B - 1);
+    int seen = 0;
+    for (int x : v) CHECK(x == seen++);
+    CHECK(seen == B);
+}
+
+// segments() and the segment-wise algorithms with elements pushed to the front.
+void segments_with_front_offset() {
+    TV v;
+    deque<int> ref;
+    for (int i = 0; i < 9; ++i) {
+        v.push_back(i);
+        ref.push_back(i);
+    }
+    for (int i = 1; i <= 6; ++i) {
+        v.push_front(-i);
+        ref.push_front(-i);
+    }
+    CHECK(v.segment(0).size() < size_t(B));
+
+    size_t i = 0, b = 0;
+    for (span<int> seg : v.segments()) {
+        CHECK(seg.data() == &v[i] && v.segment_offset(b++) == i);
+        for (int x : seg) CHECK(x == ref[i++]);
+    }
+    CHECK(i == ref.size() && b == v.segment_count());
+
+    arithmetic(v);
+
+    vector<int> out(v.size());
+    copy(v.begin() + 1, v.end() - 1, out.begin());
+    CHECK(equal(ref.begin() + 1, ref.end() - 1, out.begin()));
+    CHECK(accumulate(v.begin() + 2, v.end(), 0) == accumulate(ref.begin() + 2, ref.end(), 0));
+    CHECK(find(v.begin(), v.end(), 3) == v.begin() + 9);
+    CHECK(find(v.begin() + 10, v.end(), 3) == v.end());
+    fill(v.begin() + 3, v.begin() + 11, 7);
+    for (size_t k = 0; k < v.size(); ++k) CHECK(v[k] == (k >= 3 && k < 11 ? 7 : ref[k]));
+}
+
+int main() {
+    TV empty;
+    CHECK(empty.begin() == empty.end() && empty.end() - empty.begin() == 0);
+
+    TV v;
+    for (int i = 0; i < 3 * B + 1; ++i) v.push_back(i);
+    arithmetic(v);
+    end_on_block_boundary();
+    segments_with_front_offset();
+    return 0;
+}
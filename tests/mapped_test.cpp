@@ -0,0 +1,108 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "../mapped_tiered_vector.hpp"
+#include "check.hpp"
+using namespace std;
+using namespace cppx;
+
+using Mapped = mapped_tiered_vector<int, 10>;
+
+const string path = "mapped_test.bin";
+
+string read_file() {
+    ifstream in(path, ios::binary);
+    return string(istreambuf_iterator<char>(in), {});
+}
+
+void write_file(const string& bytes) {
+    ofstream(path, ios::binary | ios::trunc) << bytes;
+}
+
+// Overwrites a 64-bit header field; offsets follow file_header.
+void patch_u64(size_t offset, uint64_t value) {
+    string bytes = read_file();
+    memcpy(bytes.data() + offset, &value, sizeof(value));
+    write_file(bytes);
+}
+
+const size_t element_size_offset = 16;
+const size_t size_offset = 24;
+const size_t blocks_offset = 32;
+
+void make_valid(size_t n) {
+    remove(path.c_str());
+    Mapped v(path);
+    for (size_t i = 0; i < n; ++i) v.push_back((int)i);
+}
+
+// The file must be rejected with EINVAL and left exactly as it was.
+void check_rejected() {
+    string before = read_file();
+    bool thrown = false;
+    try {
+        Mapped v(path);
+    } catch (const system_error& e) {
+        thrown = e.code().value() == EINVAL;
+    }
+    CHECK(thrown);
+    CHECK(read_file() == before);
+}
+
+void fresh_and_reopen() {
+    make_valid(5000);
+    Mapped v(path);
+    CHECK(v.size() == 5000);
+    for (size_t i = 0; i < v.size(); ++i) CHECK(v[i] == (int)i);
+}
+
+void short_file() {
+    write_file("not a tiered_vector file, just a few bytes");
+    check_rejected();
+}
+
+void bad_magic() {
+    make_valid(100);
+    string bytes = read_file();
+    bytes[0] = 'X';
+    write_file(bytes);
+    check_rejected();
+}
+
+void wrong_element_size() {
+    make_valid(100);
+    patch_u64(element_size_offset, 8);
+    check_rejected();
+}
+
+void truncated_blocks() {
+    make_valid(5000);
+    string bytes = read_file();
+    write_file(bytes.substr(0, bytes.size() - 1));
+    check_rejected();
+}
+
+void blocks_beyond_file() {
+    make_valid(5000);
+    patch_u64(blocks_offset, uint64_t(1) << 60);
+    check_rejected();
+}
+
+void size_beyond_blocks() {
+    make_valid(5000);
+    patch_u64(size_offset, 1000000);
+    check_rejected();
+}
+
+int main() {
+    fresh_and_reopen();
+    short_file();
+    bad_magic();
+    wrong_element_size();
+    truncated_blocks();
+    blocks_beyond_file();
+    size_beyond_blocks();
+    remove(path.c_str());
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include "../tiered_vector.hpp"
+#include "check.hpp"
+using namespace std;
+using namespace cppx;
+
+using TV = tiered_vector<int, 4>;
+constexpr size_t block_bytes = TV::block_size * sizeof(int);
+
+// Leaves one block parked in tv's own cache.
+void park_one_block(TV& tv) {
+    for (int i = 0; i < 100; ++i) tv.push_back(i);
+    for (size_t i = 0; i < TV::block_size; ++i) tv.pop_back();
+    CHECK(tv.cache_stats().cached == 1);
+}
+
+// A moved-to vector takes the cache over, so it still counts and trims it;
+// the moved-from one no longer refers to it.
+void move_keeps_ownership() {
+    TV a;
+    park_one_block(a);
+    size_t before = a.memory_usage();
+
+    TV b(move(a));
+    CHECK(b.memory_usage() == before);
+    CHECK(a.cache_stats().cached == 0);
+
+    b.shrink_to_fit();
+    CHECK(b.cache_stats().cached == 0);
+    CHECK(b.memory_usage() == b.allocated_blocks() * block_bytes);
+}
+
+// A cache installed with set_block_cache() is not the container's own, even
+// when nothing else holds it.
+void installed_cache_is_not_owned() {
+    TV tv;
+    tv.set_block_cache(make_shared<TV::block_cache_type>(4));
+    park_one_block(tv);
+    CHECK(tv.memory_usage() == tv.allocated_blocks() * block_bytes);
+    tv.shrink_to_fit();
+    CHECK(tv.cache_stats().cached == 1);
+}
+
+// Handing the cache out through get_block_cache() gives up ownership even
+// after the returned pointer is dropped.
+void handed_out_cache_is_not_owned() {
+    TV a, b;
+    park_one_block(a);
+    b.set_block_cache(a.get_block_cache());
+    a.shrink_to_fit();
+    CHECK(b.cache_stats().cached == 1);
+    CHECK(a.memory_usage() == a.allocated_blocks() * block_bytes);
+}
+
+// recycle() runs from release(), so from the destructor and noexcept move
+// assignment; it must not be able to throw.
+static_assert(noexcept(declval<TV::block_cache_type&>().recycle(nullptr)));
+static_assert(noexcept(declval<TV&>() = declval<TV&&>()));
+
+// Blocks parked up to a raised limit are all reused, on the private lock-free
+// path and on a shared cache alike.
+void raised_limit_reuses_blocks() {
+    TV own;
+    own.set_block_cache_limit(8);
+    auto shared = make_shared<TV::block_cache_type>(8);
+    TV other;
+    other.set_block_cache(shared);
+    for (TV* tv : {&own, &other}) {
+        for (int i = 0; i < 80; ++i) tv->push_back(i);
+        for (int round = 0; round < 3; ++round) {
+            for (int i = 0; i < 8 * int(TV::block_size); ++i) tv->push_back(i);
+            for (int i = 0; i < 8 * int(TV::block_size); ++i) tv->pop_back();
+        }
+        block_cache_stats st = tv->cache_stats();
+        CHECK(st.cached == 8 && st.freed == 0);
+        CHECK(st.hits == 16);
+    }
+}
+
+int main() {
+    raised_limit_reuses_blocks();
+    move_keeps_ownership();
+    installed_cache_is_not_owned();
+    handed_out_cache_is_not_owned();
+    return 0;
+}
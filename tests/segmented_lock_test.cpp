@@ -0,0 +1,106 @@
+#include <thread>
+#include <vector>
+
+#include "../segmented_lock_tiered_vector.hpp"
+#include "check.hpp"
+using namespace std;
+using namespace cppx;
+
+// Readers index everything below the size they observe while one thread keeps
+// appending across new blocks and directory segments.
+void append_while_reading() {
+    segmented_lock_tiered_vector<int, 4> v;
+    const int n = 200000;
+    atomic<bool> done{false};
+    atomic<bool> bad{false};
+
+    vector<thread> readers;
+    for (int t = 0; t < 3; ++t) {
+        readers.emplace_back([&, t] {
+            size_t i = t;
+            while (!done.load()) {
+                size_t sz = v.size();
+                if (sz == 0) continue;
+                i = (i * 7919 + 1) % sz;
+                if (v.read(i) != (int)i) bad = true;
+            }
+        });
+    }
+    for (int i = 0; i < n; ++i) v.push_back(i);
+    done = true;
+    for (thread& th : readers) th.join();
+
+    CHECK(!bad);
+    CHECK(v.size() == (size_t)n);
+}
+
+void writers_on_blocks() {
+    segmented_lock_tiered_vector<long long, 6> v;
+    v.resize(1 << 16, 0);
+
+    vector<thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&] {
+            for (size_t i = 0; i < v.size(); ++i) v.update(i, [](long long& x) { ++x; });
+        });
+    }
+    for (thread& th : writers) th.join();
+    for (size_t i = 0; i < v.size(); ++i) CHECK(v.read(i) == 4);
+}
+
+// Shrinking frees blocks; growing again must publish the blocks now in use.
+void shrink_and_regrow() {
+    segmented_lock_tiered_vector<int, 3> v;
+    v.resize(1000, 1);
+    v.resize(20);
+    v.resize(3000, 2);
+    CHECK(v.size() == 3000);
+    for (size_t i = 0; i < 20; ++i) CHECK(v.read(i) == 1);
+    for (size_t i = 20; i < 3000; ++i) CHECK(v.read(i) == 2);
+    v.write(2999, 7);
+    CHECK(v.read(2999) == 7);
+}
+
+// Bytes held through counting_allocator, and how many allocations were of
+// the cache-line aligned directory slots.
+struct alloc_counters {
+    static inline long live_bytes = 0;
+    static inline long slot_allocs = 0;
+};
+
+template <typename U>
+struct counting_allocator {
+    using value_type = U;
+    counting_allocator() = default;
+    template <typename V> counting_allocator(const counting_allocator<V>&) {}
+
+    U* allocate(size_t n) {
+        alloc_counters::live_bytes += long(n * sizeof(U));
+        if constexpr (alignof(U) == 64) alloc_counters::slot_allocs++;
+        return std::allocator<U>().allocate(n);
+    }
+    void deallocate(U* p, size_t n) {
+        alloc_counters::live_bytes -= long(n * sizeof(U));
+        std::allocator<U>().deallocate(p, n);
+    }
+    template <typename V> bool operator==(const counting_allocator<V>&) const {return true;}
+};
+
+// The directory segments come from the container's allocator, like its blocks.
+void directory_uses_allocator() {
+    {
+        segmented_lock_tiered_vector<int, 3, counting_allocator<int>> v;
+        v.resize(1000, 1);
+        CHECK(alloc_counters::slot_allocs > 1);
+        CHECK(v.read(999) == 1);
+    }
+    CHECK(alloc_counters::live_bytes == 0);
+}
+
+int main() {
+    append_while_reading();
+    writers_on_blocks();
+    shrink_and_regrow();
+    directory_uses_allocator();
+    return 0;
+}
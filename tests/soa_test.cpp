@@ -0,0 +1,104 @@
+#include <chrono>
+#include <string>
+
+#include "../tiered_soa.hpp"
+#include "check.hpp"
+using namespace std;
+using namespace cppx;
+
+// Appends across many blocks: with 16-row blocks, 2M rows span 125000 blocks.
+// The spine must grow geometrically, so this stays well under a second.
+void append_many_blocks() {
+    basic_tiered_soa<4, std::allocator<int>, int, double> soa;
+    const size_t n = 2000000;
+
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i) soa.emplace_back((int)i, i * 0.5);
+    double secs = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    CHECK(soa.size() == n);
+    CHECK(soa.segment_count() == n / 16);
+    CHECK(secs < 5.0);
+    for (size_t i = 0; i < n; i += 997) {
+        CHECK(soa.get<0>(i) == (int)i);
+        CHECK(soa.get<1>(i) == i * 0.5);
+    }
+
+    while (soa.size() > n / 2) soa.pop_back();
+    CHECK(soa.segment_count() == n / 32);
+    for (size_t i = 0; i < n / 2; ++i) soa.emplace_back(0, 0.0);
+    CHECK(soa.size() == n);
+}
+
+void rows_and_columns() {
+    tiered_soa<int, string> soa;
+    for (int i = 0; i < 5000; ++i) soa.push_back({i, to_string(i)});
+
+    long long sum = 0;
+    soa.for_each_segment<0>([&](span<int> s) { for (int x : s) sum += x; });
+    CHECK(sum == 5000LL * 4999 / 2);
+
+    size_t i = 0;
+    for (auto [id, name] : soa) {
+        CHECK(id == (int)i);
+        CHECK(name == to_string(i));
+        ++i;
+    }
+    CHECK(i == soa.size());
+}
+
+// Counts allocate() calls and bytes held through any rebound copy.
+struct alloc_counters {
+    static inline long allocs = 0;
+    static inline long live_bytes = 0;
+};
+
+template <typename U>
+struct counting_allocator {
+    using value_type = U;
+    counting_allocator() = default;
+    template <typename V> counting_allocator(const counting_allocator<V>&) {}
+
+    U* allocate(size_t n) {
+        alloc_counters::allocs++;
+        alloc_counters::live_bytes += long(n * sizeof(U));
+        return std::allocator<U>().allocate(n);
+    }
+    void deallocate(U* p, size_t n) {
+        alloc_counters::live_bytes -= long(n * sizeof(U));
+        std::allocator<U>().deallocate(p, n);
+    }
+    template <typename V> bool operator==(const counting_allocator<V>&) const {return true;}
+};
+
+// Blocks come from the container's allocator, and a size oscillating around a
+// block boundary reuses the spare block set instead of allocating each time.
+void allocator_and_spare_block() {
+    {
+        basic_tiered_soa<4, counting_allocator<char>, int, string> soa;
+        soa.reserve(64);
+        for (int i = 0; i < 32; ++i) soa.emplace_back(i, to_string(i));
+        CHECK(alloc_counters::live_bytes > 0);
+
+        long before = alloc_counters::allocs;
+        for (int round = 0; round < 100; ++round) {
+            soa.pop_back();
+            soa.emplace_back(round, "x");
+        }
+        CHECK(alloc_counters::allocs == before);
+        CHECK(soa.size() == 32 && soa.get<0>(31) == 99 && soa.get<1>(31) == "x");
+
+        soa.clear();
+        CHECK(soa.empty());
+        soa.emplace_back(1, "a");
+        CHECK(alloc_counters::allocs == before);
+    }
+    CHECK(alloc_counters::live_bytes == 0);
+}
+
+int main() {
+    append_many_blocks();
+    rows_and_columns();
+    allocator_and_spare_block();
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+#include "../tiered_parallel.hpp"
+#include "check.hpp"
+using namespace std;
+using namespace cppx;
+
+parallel::thread_pool pool(4);
+
+template <typename TV>
+TV random_tv(size_t n, unsigned seed) {
+    mt19937 rng(seed);
+    TV tv;
+    for (size_t i = 0; i < n; ++i) tv.push_back((int)(rng() % 1000) - 500);
+    return tv;
+}
+
+void sorts_ints() {
+    for (size_t n : {0, 1, 63, 64, 65, 1000, 100000}) {
+        auto tv = random_tv<tiered_vector<int, 6>>(n, (unsigned)n);
+        vector<int> expected(tv.begin(), tv.end());
+        std::sort(expected.begin(), expected.end());
+
+        auto a = tv;
+        cppx::sort(a, std::less<>{}, pool);
+        CHECK(equal(a.begin(), a.end(), expected.begin(), expected.end()));
+
+        auto b = tv;
+        cppx::sort(b, [](int x, int y) { return x < y; }, pool);
+        CHECK(equal(b.begin(), b.end(), expected.begin(), expected.end()));
+
+        auto c = tv;
+        cppx::radix_sort(c, pool);
+        CHECK(equal(c.begin(), c.end(), expected.begin(), expected.end()));
+    }
+}
+
+void stable_keeps_ties() {
+    tiered_vector<pair<int, int>, 5> tv;
+    mt19937 rng(7);
+    for (int i = 0; i < 5000; ++i) tv.push_back({(int)(rng() % 10), i});
+    cppx::stable_sort(tv, [](const auto& x, const auto& y) { return x.first < y.first; }, pool);
+    for (size_t i = 1; i < tv.size(); ++i) {
+        CHECK(tv[i - 1].first <= tv[i].first);
+        if (tv[i - 1].first == tv[i].first) CHECK(tv[i - 1].second < tv[i].second);
+    }
+}
+
+atomic<long> live{0};
+
+// Counts live objects, so a leak or a double destroy shows up in `live`.
+struct Tracked {
+    string value;
+    Tracked() { ++live; }
+    Tracked(string v) : value(move(v)) { ++live; }
+    Tracked(const Tracked& o) : value(o.value) { ++live; }
+    Tracked(Tracked&& o) noexcept : value(move(o.value)) { ++live; }
+    Tracked& operator=(const Tracked&) = default;
+    Tracked& operator=(Tracked&&) noexcept = default;
+    ~Tracked() { --live; }
+};
+
+// Throws on the limit-th call; used in the block sort and in the merge phase.
+struct ThrowingLess {
+    atomic<long>* calls;
+    long limit;
+    bool operator()(const Tracked& a, const Tracked& b) const {
+        if (++*calls == limit) throw runtime_error("compare");
+        return a.value < b.value;
+    }
+};
+
+// The basic guarantee: after comp throws, tv keeps its size and valid objects
+// (possibly moved-from), nothing leaks, and it can be sorted again.
+void throwing_comparator() {
+    for (long limit : {10L, 20000L, 60000L}) {
+        {
+            tiered_vector<Tracked, 6> tv;
+            for (int i = 0; i < 5000; ++i) tv.push_back(Tracked(to_string((i * 7919) % 5000)));
+            atomic<long> calls{0};
+            CHECK_THROWS(runtime_error, cppx::sort(tv, ThrowingLess{&calls, limit}, pool));
+            CHECK(tv.size() == 5000);
+            CHECK(live == 5000);
+
+            size_t chars = 0;
+            for (const Tracked& t : tv) chars += t.value.size();
+            CHECK(chars <= 5000 * 4);
+
+            atomic<long> more{0};
+            cppx::sort(tv, ThrowingLess{&more, -1}, pool);
+            for (size_t i = 1; i < tv.size(); ++i) CHECK(!(tv[i].value < tv[i - 1].value));
+        }
+        CHECK(live == 0);
+    }
+}
+
+int main() {
+    sorts_ints();
+    stable_keeps_ties();
+    throwing_comparator();
+    return 0;
+}
@@ -0,0 +1,165 @@
+#pragma once
+#include "tiered_vector.hpp"
+#include <sys/mman.h>
+
+namespace cppx {
+
+// Block allocation policies, plugged in through tiered_vector's Allocator
+// parameter:
+//
+//   tiered_vector<int, default_block_bits<int>(), aligned_allocator<int>>     64-byte aligned blocks
+//   tiered_vector<int, default_block_bits<int>(), huge_page_allocator<int>>   blocks carved from 2 MB huge pages
+//
+// Neither defines construct(), so the memcpy bulk paths stay enabled.
+
+// Every allocation aligned to Align bytes (at least alignof(T)), so each block
+// starts on a cache line and aligned SIMD loads work from the block start.
+template <typename T, size_t Align = 64>
+struct aligned_allocator{
+    static_assert((Align & (Align - 1)) == 0, "Align must be a power of two");
+
+    using value_type = T;
+    static constexpr std::align_val_t alignment{std::max(Align, alignof(T))};
+
+    template <typename U>
+    struct rebind{using other = aligned_allocator<U, Align>;};
+
+    aligned_allocator() noexcept = default;
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Align>&) noexcept {}
+
+    T* allocate(size_t n){
+        return static_cast<T*>(::operator new(n * sizeof(T), alignment));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        ::operator delete(p, n * sizeof(T), alignment);
+    }
+
+    template <typename U>
+    bool operator==(const aligned_allocator<U, Align>&) const noexcept {return true;}
+};
+
+// Memory for huge_page_allocator: 2 MB-aligned regions mapped anonymously and
+// marked MADV_HUGEPAGE, so the kernel can back each with one huge page and a
+// random access costs one TLB entry per 2 MB instead of per 4 KB. Allocations
+// are carved off the current region 64-byte aligned; freed ones go to a free
+// list per size (a tiered_vector's blocks all have one size, so they are reused
+// exactly). Requests larger than a region get a dedicated huge-page mapping.
+// Regions are returned to the OS when the last allocator using the arena dies.
+class huge_page_arena{
+    public:
+        static constexpr size_t region_size = size_t(2) << 20;
+        static constexpr size_t granule = 64;
+
+    private:
+        std::mutex mtx;
+        std::vector<void*> regions;
+        std::unordered_map<size_t, std::vector<void*>> free_lists;
+        char* cursor = nullptr;
+        char* limit = nullptr;
+
+        // Maps bytes (a multiple of region_size) aligned to region_size.
+        static void* map_aligned(size_t bytes){
+            size_t span = bytes + region_size;
+            void* raw = ::mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if(raw == MAP_FAILED) throw std::bad_alloc();
+
+            uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+            uintptr_t aligned = (start + region_size - 1) & ~(uintptr_t(region_size) - 1);
+            if(aligned > start) ::munmap(raw, aligned - start);
+            size_t tail = (start + span) - (aligned + bytes);
+            if(tail > 0) ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+
+#ifdef MADV_HUGEPAGE
+            ::madvise(reinterpret_cast<void*>(aligned), bytes, MADV_HUGEPAGE);
+#endif
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        static size_t round_up(size_t bytes, size_t to){return (bytes + to - 1) / to * to;}
+
+    public:
+        huge_page_arena() = default;
+        huge_page_arena(const huge_page_arena&) = delete;
+        huge_page_arena& operator= (const huge_page_arena&) = delete;
+
+        ~huge_page_arena(){
+            for(void* region : regions) ::munmap(region, region_size);
+        }
+
+        void* allocate(size_t bytes){
+            bytes = round_up(std::max<size_t>(bytes, 1), granule);
+            if(bytes > region_size) return map_aligned(round_up(bytes, region_size));
+
+            std::lock_guard<std::mutex> lock(mtx);
+            auto it = free_lists.find(bytes);
+            if(it != free_lists.end() && !it->second.empty()){
+                void* p = it->second.back();
+                it->second.pop_back();
+                return p;
+            }
+            if(cursor == nullptr || size_t(limit - cursor) < bytes){
+                regions.reserve(regions.size() + 1);
+                cursor = static_cast<char*>(map_aligned(region_size));
+                limit = cursor + region_size;
+                regions.push_back(cursor);
+            }
+            void* p = cursor;
+            cursor += bytes;
+            return p;
+        }
+
+        void deallocate(void* p, size_t bytes){
+            bytes = round_up(std::max<size_t>(bytes, 1), granule);
+            if(bytes > region_size){
+                ::munmap(p, round_up(bytes, region_size));
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mtx);
+            free_lists[bytes].push_back(p);
+        }
+
+        size_t region_count(){
+            std::lock_guard<std::mutex> lock(mtx);
+            return regions.size();
+        }
+};
+
+// Allocator over a shared huge_page_arena. A default-constructed allocator
+// (what a default-constructed tiered_vector gets) starts a new arena; copies and
+// rebinds share it and compare equal.
+template <typename T>
+class huge_page_allocator{
+    template <typename> friend class huge_page_allocator;
+
+    std::shared_ptr<huge_page_arena> arena;
+
+    public:
+        using value_type = T;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+        using is_always_equal = std::false_type;
+
+        huge_page_allocator() : arena(std::make_shared<huge_page_arena>()) {}
+        explicit huge_page_allocator(std::shared_ptr<huge_page_arena> shared) : arena(move(shared)) {}
+
+        template <typename U>
+        huge_page_allocator(const huge_page_allocator<U>& other) noexcept : arena(other.arena) {}
+
+        T* allocate(size_t n){
+            static_assert(alignof(T) <= huge_page_arena::granule, "over-aligned T is not supported");
+            return static_cast<T*>(arena->allocate(n * sizeof(T)));
+        }
+
+        void deallocate(T* p, size_t n){
+            arena->deallocate(p, n * sizeof(T));
+        }
+
+        const std::shared_ptr<huge_page_arena>& get_arena() const {return arena;}
+
+        template <typename U>
+        bool operator==(const huge_page_allocator<U>& other) const noexcept {return arena == other.arena;}
+};
+
+}
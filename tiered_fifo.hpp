@@ -0,0 +1,151 @@
+#pragma once
+#include "tiered_vector.hpp"
+
+namespace cppx {
+
+// Bounded FIFO window: append at the back, drop from the front, O(1) random
+// access into what is left. Meant for sliding windows over a stream ("the last
+// N events").
+//
+// The spine is a ring of 2^k block slots, so element i sits at ring position
+// (head + i) & ring_mask and indexing stays a shift and a mask. A block whose
+// last element is dropped goes back to a block_cache, and the back takes its
+// next block from the same cache, so once the window is full the container does
+// no allocation at all. Pushing into a full window evicts the oldest element.
+template <typename T, size_t BlockBits = default_block_bits<T>(), typename Allocator = std::allocator<T>>
+class tiered_fifo{
+    static_assert(BlockBits > 0 && BlockBits < 32, "BlockBits must be in [1, 31]");
+
+    public:
+        static constexpr size_t block_bits = BlockBits;
+        static constexpr size_t block_size = size_t(1) << BlockBits;
+        static constexpr size_t block_mask = block_size - 1;
+
+        using value_type = T;
+        using allocator_type = Allocator;
+        using block_cache_type = block_cache<T, BlockBits, Allocator>;
+
+    private:
+        using alloc_traits    = std::allocator_traits<Allocator>;
+        using spine_allocator = typename alloc_traits::template rebind_alloc<T*>;
+
+        static_assert(is_same_v<typename alloc_traits::pointer, T*>, "fancy pointers are not supported");
+
+        std::vector<T*, spine_allocator> spine;
+        size_t ring_mask;
+        size_t head;
+        size_t sz;
+        size_t max_sz;
+        [[no_unique_address]] Allocator alloc;
+        std::shared_ptr<block_cache_type> cache;
+
+        T* slot(size_t idx) const {
+            size_t p = (head + idx)&ring_mask;
+            return spine[p>>BlockBits] + (p&block_mask);
+        }
+
+    public:
+        // A window of up to max_size elements. The spine gets one spare slot so
+        // a window that does not start on a block boundary still fits, and the
+        // cache keeps two spare blocks, enough for steady-state turnover.
+        explicit tiered_fifo(size_t max_size, const Allocator& a = Allocator()) :
+            spine(spine_allocator(a)), head(0), sz(0), max_sz(max_size), alloc(a),
+            cache(std::make_shared<block_cache_type>(2, a))
+        {
+            assert(max_size > 0);
+            size_t slots = std::bit_ceil(((max_size + block_mask) >> BlockBits) + 1);
+            spine.assign(slots, nullptr);
+            ring_mask = (slots<<BlockBits) - 1;
+        }
+
+        tiered_fifo(const tiered_fifo&) = delete;
+        tiered_fifo& operator= (const tiered_fifo&) = delete;
+
+        ~tiered_fifo(){
+            clear();
+            for(T* block : spine){
+                if(block != nullptr) cache->recycle(block);
+            }
+        }
+
+        // Appends value, evicting the oldest element first if the window is full.
+        template <typename... Args>
+        T& emplace_back(Args&&... args){
+            if(sz == max_sz) pop_front();
+
+            size_t p = (head + sz)&ring_mask;
+            T*& block = spine[p>>BlockBits];
+            if(block == nullptr) block = cache->acquire();
+
+            T* target = block + (p&block_mask);
+            alloc_traits::construct(alloc, target, std::forward<Args>(args)...);
+            sz++;
+            return *target;
+        }
+
+        void push_back(const T& value){
+            emplace_back(value);
+        }
+
+        void push_back(T&& value){
+            emplace_back(move(value));
+        }
+
+        void pop_front(){
+            if(sz == 0) return;
+
+            alloc_traits::destroy(alloc, slot(0));
+            sz--;
+            size_t next = (head + 1)&ring_mask;
+            // Leaving a block (or emptying the window) hands it back to the cache.
+            if((next&block_mask) == 0 || sz == 0){
+                cache->recycle(spine[head>>BlockBits]);
+                spine[head>>BlockBits] = nullptr;
+            }
+            head = sz == 0 ? 0 : next;
+        }
+
+        void clear(){
+            while(sz > 0) pop_front();
+        }
+
+        T& operator[](size_t idx){return *slot(idx);}
+        const T& operator[](size_t idx) const {return *slot(idx);}
+
+        T& front(){return *slot(0);}
+        const T& front() const {return *slot(0);}
+        T& back(){return *slot(sz - 1);}
+        const T& back() const {return *slot(sz - 1);}
+
+        // Calls f(std::span) for each contiguous run of the window, oldest first.
+        template <typename F>
+        void for_each_segment(F&& f){
+            for(size_t i = 0; i < sz;){
+                size_t p = (head + i)&ring_mask;
+                size_t n = std::min(sz - i, block_size - (p&block_mask));
+                f(std::span<T>(spine[p>>BlockBits] + (p&block_mask), n));
+                i += n;
+            }
+        }
+
+        template <typename F>
+        void for_each_segment(F&& f) const {
+            for(size_t i = 0; i < sz;){
+                size_t p = (head + i)&ring_mask;
+                size_t n = std::min(sz - i, block_size - (p&block_mask));
+                f(std::span<const T>(spine[p>>BlockBits] + (p&block_mask), n));
+                i += n;
+            }
+        }
+
+        std::shared_ptr<block_cache_type> get_block_cache(){return cache;}
+        block_cache_stats cache_stats() const {return cache->stats();}
+
+        size_t size() const {return sz;}
+        size_t max_size() const {return max_sz;}
+        bool empty() const {return sz == 0;}
+        bool full() const {return sz == max_sz;}
+        allocator_type get_allocator() const {return alloc;}
+};
+
+}
@@ -0,0 +1,197 @@
+#pragma once
+#include "tiered_vector.hpp"
+#include <climits>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace cppx {
+
+// Binary save/load for tiered_vector of trivially copyable T.
+//
+// The format is a 32-byte header (magic, version, block_bits, element size,
+// element count) followed by the elements in index order. Blocks are written
+// and read in place: save() hands the header plus one iovec per block to
+// writev, and load() sizes the container first and then readv's straight into
+// its freshly allocated blocks, so no intermediate buffer is involved. The
+// block size is recorded but not required to match when loading.
+//
+// A single writev/readv takes at most IOV_MAX buffers, so very large containers
+// are transferred in IOV_MAX-block batches. Short transfers are resumed. OS
+// errors are thrown as std::system_error, a bad or truncated file and a failed
+// stream write as std::runtime_error.
+//
+// load() never trusts the header's element count for allocation: a regular
+// file or seekable stream that is shorter than it claims is rejected up front,
+// and any other input is read in batches that at most double what has already
+// arrived, so a corrupt count costs at most twice the bytes actually present.
+// A bad header or a count the input cannot hold is rejected before tv is
+// touched; if reading fails after that, tv is left empty.
+namespace io_detail {
+    struct file_header{
+        char magic[8];
+        uint32_t version;
+        uint32_t block_bits;
+        uint64_t element_size;
+        uint64_t size;
+    };
+
+    inline constexpr char magic[8] = {'C','P','P','X','T','V','S','1'};
+
+    inline file_header make_header(size_t block_bits, size_t element_size, size_t size){
+        file_header h{};
+        std::memcpy(h.magic, magic, sizeof(magic));
+        h.version = 1;
+        h.block_bits = static_cast<uint32_t>(block_bits);
+        h.element_size = element_size;
+        h.size = size;
+        return h;
+    }
+
+    inline void check_header(const file_header& h, size_t element_size){
+        if(std::memcmp(h.magic, magic, sizeof(magic)) != 0 || h.version != 1){
+            throw std::runtime_error("tiered_vector load: not a tiered_vector file");
+        }
+        if(h.element_size != element_size){
+            throw std::runtime_error("tiered_vector load: element size mismatch");
+        }
+    }
+
+    // Runs writev/readv until every buffer in iov is transferred.
+    template <typename Transfer>
+    void transfer_all(int fd, std::vector<iovec>& iov, Transfer transfer, const char* what){
+        size_t first = 0;
+        while(first < iov.size()){
+            int count = static_cast<int>(std::min<size_t>(iov.size() - first, IOV_MAX));
+            ssize_t done = transfer(fd, iov.data() + first, count);
+            if(done < 0){
+                if(errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), what);
+            }
+            if(done == 0) throw std::runtime_error(std::string("tiered_vector ") + what + ": no bytes transferred (unexpected end of file)");
+
+            size_t left = static_cast<size_t>(done);
+            while(first < iov.size() && left >= iov[first].iov_len) left -= iov[first++].iov_len;
+            if(left > 0){
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) + left;
+                iov[first].iov_len -= left;
+            }
+        }
+    }
+
+    [[noreturn]] inline void truncated(){
+        throw std::runtime_error("tiered_vector load: input is shorter than its element count");
+    }
+
+    // Elements to allocate and read next, starting from `done` (a multiple of
+    // block_size): as many as were already read, and at least about 1 MB.
+    inline size_t next_batch(size_t done, size_t total, size_t block_size, size_t element_size){
+        size_t floor_blocks = std::max<size_t>(1, (size_t(1) << 20) / (block_size * element_size));
+        return std::min(total - done, std::max(done, floor_blocks * block_size));
+    }
+}
+
+template <typename T, size_t BlockBits, typename Allocator>
+void save(const tiered_vector<T, BlockBits, Allocator>& tv, int fd){
+    static_assert(is_trivially_copyable_v<T>, "save() writes raw bytes; T must be trivially copyable");
+
+    io_detail::file_header h = io_detail::make_header(BlockBits, sizeof(T), tv.size());
+    std::vector<iovec> iov;
+    iov.reserve(tv.segment_count() + 1);
+    iov.push_back({&h, sizeof(h)});
+    for(std::span<const T> seg : tv.segments()){
+        iov.push_back({const_cast<T*>(seg.data()), seg.size_bytes()});
+    }
+    io_detail::transfer_all(fd, iov, ::writev, "writev");
+}
+
+// Replaces the contents of tv with what save() wrote to fd.
+template <typename T, size_t BlockBits, typename Allocator>
+void load(tiered_vector<T, BlockBits, Allocator>& tv, int fd){
+    static_assert(is_trivially_copyable_v<T>, "load() reads raw bytes; T must be trivially copyable");
+
+    io_detail::file_header h;
+    std::vector<iovec> iov{{&h, sizeof(h)}};
+    io_detail::transfer_all(fd, iov, ::readv, "readv");
+    io_detail::check_header(h, sizeof(T));
+
+    struct stat st;
+    if(::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)){
+        off_t pos = ::lseek(fd, 0, SEEK_CUR);
+        if(pos >= 0 && h.size > static_cast<uint64_t>(st.st_size - std::min(st.st_size, pos)) / sizeof(T)) io_detail::truncated();
+    }
+
+    tv.clear();
+    try{
+        size_t done = 0;
+        while(done < h.size){
+            tv.resize_for_overwrite(done + io_detail::next_batch(done, h.size, tv.block_size, sizeof(T)));
+            iov.clear();
+            for(size_t b = done >> BlockBits; b < tv.segment_count(); ++b){
+                std::span<T> seg = tv.segment(b);
+                iov.push_back({seg.data(), seg.size_bytes()});
+            }
+            io_detail::transfer_all(fd, iov, ::readv, "readv");
+            done = tv.size();
+        }
+    }
+    catch(...){
+        tv.clear();
+        throw;
+    }
+}
+
+// Stream versions: one write()/read() call per block.
+template <typename T, size_t BlockBits, typename Allocator>
+void save(const tiered_vector<T, BlockBits, Allocator>& tv, std::ostream& os){
+    static_assert(is_trivially_copyable_v<T>, "save() writes raw bytes; T must be trivially copyable");
+
+    io_detail::file_header h = io_detail::make_header(BlockBits, sizeof(T), tv.size());
+    os.write(reinterpret_cast<const char*>(&h), sizeof(h));
+    for(std::span<const T> seg : tv.segments()){
+        if(!os) break;
+        os.write(reinterpret_cast<const char*>(seg.data()), static_cast<std::streamsize>(seg.size_bytes()));
+    }
+    if(!os) throw std::runtime_error("tiered_vector save: stream write failed");
+}
+
+template <typename T, size_t BlockBits, typename Allocator>
+void load(tiered_vector<T, BlockBits, Allocator>& tv, std::istream& is){
+    static_assert(is_trivially_copyable_v<T>, "load() reads raw bytes; T must be trivially copyable");
+
+    io_detail::file_header h;
+    if(!is.read(reinterpret_cast<char*>(&h), sizeof(h))){
+        throw std::runtime_error("tiered_vector load: unexpected end of stream");
+    }
+    io_detail::check_header(h, sizeof(T));
+
+    // Streams that cannot seek report -1 and are only bounded by batching.
+    std::streampos pos = is.tellg();
+    if(pos != std::streampos(-1) && is.seekg(0, std::ios::end)){
+        std::streamoff left = is.tellg() - pos;
+        is.seekg(pos);
+        if(left >= 0 && h.size > static_cast<uint64_t>(left) / sizeof(T)) io_detail::truncated();
+    }
+    is.clear(is.rdstate() & ~std::ios::failbit);
+
+    tv.clear();
+    try{
+        size_t done = 0;
+        while(done < h.size){
+            tv.resize_for_overwrite(done + io_detail::next_batch(done, h.size, tv.block_size, sizeof(T)));
+            for(size_t b = done >> BlockBits; b < tv.segment_count(); ++b){
+                std::span<T> seg = tv.segment(b);
+                if(!is.read(reinterpret_cast<char*>(seg.data()), static_cast<std::streamsize>(seg.size_bytes()))){
+                    throw std::runtime_error("tiered_vector load: unexpected end of stream");
+                }
+            }
+            done = tv.size();
+        }
+    }
+    catch(...){
+        tv.clear();
+        throw;
+    }
+}
+
+}
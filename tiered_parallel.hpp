@@ -0,0 +1,496 @@
+#pragma once
+#include "tiered_vector.hpp"
+
+namespace cppx {
+namespace parallel {
+
+// Fixed set of worker threads that runs "task i of n" jobs. Tasks start out
+// split evenly between the participants (the workers plus the calling thread);
+// a participant that runs dry steals the back half of someone else's remaining
+// range, so uneven per-task cost still balances.
+class thread_pool{
+    private:
+        struct alignas(64) task_range{
+            std::mutex mtx;
+            size_t begin = 0;
+            size_t end = 0;
+        };
+
+        std::vector<std::thread> workers;
+        std::unique_ptr<task_range[]> ranges;
+        size_t participants;
+
+        std::mutex run_mtx;
+        std::mutex mtx;
+        std::condition_variable wake;
+        std::condition_variable done;
+        size_t generation = 0;
+        size_t active = 0;
+        bool stopping = false;
+        void* job_ctx = nullptr;
+        void (*job_fn)(void*, size_t) = nullptr;
+        std::exception_ptr error;
+
+        static thread_pool*& current(){
+            static thread_local thread_pool* pool = nullptr;
+            return pool;
+        }
+
+        bool pop(size_t self, size_t& task){
+            task_range& r = ranges[self];
+            std::lock_guard<std::mutex> lock(r.mtx);
+            if(r.begin == r.end) return false;
+            task = r.begin++;
+            return true;
+        }
+
+        bool steal(size_t self, size_t& task){
+            for(size_t k = 1; k < participants; ++k){
+                task_range& victim = ranges[(self + k) % participants];
+                size_t first, last;
+                {
+                    std::lock_guard<std::mutex> lock(victim.mtx);
+                    size_t left = victim.end - victim.begin;
+                    if(left == 0) continue;
+                    last = victim.end;
+                    first = last - (left + 1) / 2;
+                    victim.end = first;
+                }
+                if(first + 1 < last){
+                    std::lock_guard<std::mutex> lock(ranges[self].mtx);
+                    ranges[self].begin = first + 1;
+                    ranges[self].end = last;
+                }
+                task = first;
+                return true;
+            }
+            return false;
+        }
+
+        void work(size_t self){
+            thread_pool* outer = current();
+            current() = this;
+            size_t task;
+            while(pop(self, task) || steal(self, task)){
+                try{
+                    job_fn(job_ctx, task);
+                }
+                catch(...){
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if(!error) error = std::current_exception();
+                }
+            }
+            current() = outer;
+        }
+
+        void worker_loop(size_t self){
+            size_t seen = 0;
+            for(;;){
+                {
+                    std::unique_lock<std::mutex> lock(mtx);
+                    wake.wait(lock, [&]{return stopping || generation != seen;});
+                    if(stopping) return;
+                    seen = generation;
+                }
+                work(self);
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    if(--active == 0) done.notify_one();
+                }
+            }
+        }
+
+    public:
+        // `threads` counts the caller too: thread_pool(1) runs everything inline.
+        explicit thread_pool(size_t threads = std::thread::hardware_concurrency()) :
+            ranges(new task_range[std::max<size_t>(threads, 1)]),
+            participants(std::max<size_t>(threads, 1))
+        {
+            for(size_t i = 1; i < participants; ++i){
+                workers.emplace_back([this, i]{ worker_loop(i); });
+            }
+        }
+
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator= (const thread_pool&) = delete;
+
+        ~thread_pool(){
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                stopping = true;
+            }
+            wake.notify_all();
+            for(auto& t : workers) t.join();
+        }
+
+        size_t size() const {return participants;}
+
+        // Calls f(i) for every i in [0, tasks) and returns once all calls have
+        // finished. Rethrows the first exception a task threw. A nested run() from
+        // inside a task of the same pool executes inline.
+        template <typename F>
+        void run(size_t tasks, F&& f){
+            if(tasks == 0) return;
+            if(participants == 1 || tasks == 1 || current() == this){
+                for(size_t i = 0; i < tasks; ++i) f(i);
+                return;
+            }
+
+            std::lock_guard<std::mutex> serial(run_mtx);
+            for(size_t p = 0; p < participants; ++p){
+                std::lock_guard<std::mutex> lock(ranges[p].mtx);
+                ranges[p].begin = tasks * p / participants;
+                ranges[p].end = tasks * (p + 1) / participants;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mtx);
+                job_ctx = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+                job_fn = [](void* ctx, size_t i){ (*static_cast<std::remove_reference_t<F>*>(ctx))(i); };
+                active = workers.size();
+                error = nullptr;
+                ++generation;
+            }
+            wake.notify_all();
+
+            work(0);
+
+            std::exception_ptr failure;
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                done.wait(lock, [&]{return active == 0;});
+                job_ctx = nullptr;
+                job_fn = nullptr;
+                failure = error;
+                error = nullptr;
+            }
+            if(failure) std::rethrow_exception(failure);
+        }
+};
+
+// Shared pool sized to the machine, created on first use.
+inline thread_pool& default_pool(){
+    static thread_pool pool;
+    return pool;
+}
+
+// The algorithms below use one block as the unit of work: blocks never
+// overlap, so tasks touch disjoint, contiguous memory with no synchronization.
+
+template <typename T, size_t BlockBits, typename Allocator, typename F>
+void for_each(tiered_vector<T, BlockBits, Allocator>& tv, F f, thread_pool& pool = default_pool()){
+    pool.run(tv.segment_count(), [&](size_t b){
+        for(T& x : tv.segment(b)) f(x);
+    });
+}
+
+template <typename T, size_t BlockBits, typename Allocator, typename F>
+void for_each(const tiered_vector<T, BlockBits, Allocator>& tv, F f, thread_pool& pool = default_pool()){
+    pool.run(tv.segment_count(), [&](size_t b){
+        for(const T& x : tv.segment(b)) f(x);
+    });
+}
+
+// In place: x = op(x) for every element.
+template <typename T, size_t BlockBits, typename Allocator, typename UnaryOp>
+void transform(tiered_vector<T, BlockBits, Allocator>& tv, UnaryOp op, thread_pool& pool = default_pool()){
+    pool.run(tv.segment_count(), [&](size_t b){
+        for(T& x : tv.segment(b)) x = op(x);
+    });
+}
+
+// dst is resized to src.size(), then dst[i] = op(src[i]).
+template <typename T, size_t BlockBits, typename Allocator,
+          typename U, size_t DstBits, typename DstAllocator, typename UnaryOp>
+void transform(const tiered_vector<T, BlockBits, Allocator>& src, tiered_vector<U, DstBits, DstAllocator>& dst,
+               UnaryOp op, thread_pool& pool = default_pool()){
+    dst.resize(src.size());
+    // Same block size and front offset: block b of dst lines up with block b of src.
+    bool aligned = false;
+    if constexpr (BlockBits == DstBits) aligned = src.segment_offset(1) == dst.segment_offset(1);
+    pool.run(dst.segment_count(), [&](size_t b){
+        std::span<U> out = dst.segment(b);
+        size_t base = dst.segment_offset(b);
+        if(aligned){
+            std::span<const T> in = src.segment(b);
+            for(size_t i = 0; i < out.size(); ++i) out[i] = op(in[i]);
+        }
+        else{
+            for(size_t i = 0; i < out.size(); ++i) out[i] = op(src[base + i]);
+        }
+    });
+}
+
+// Reduces each block on its own, then folds the per-block results into init in
+// block order, so any associative op gives the same answer for every thread count.
+template <typename T, size_t BlockBits, typename Allocator, typename Init, typename BinaryOp = std::plus<>>
+Init reduce(const tiered_vector<T, BlockBits, Allocator>& tv, Init init, BinaryOp op = {}, thread_pool& pool = default_pool()){
+    std::vector<std::optional<Init>> partial(tv.segment_count());
+    pool.run(partial.size(), [&](size_t b){
+        std::span<const T> seg = tv.segment(b);
+        Init acc = static_cast<Init>(seg[0]);
+        for(size_t i = 1; i < seg.size(); ++i) acc = op(move(acc), seg[i]);
+        partial[b].emplace(move(acc));
+    });
+    for(auto& p : partial) init = op(move(init), move(*p));
+    return init;
+}
+
+template <typename T, size_t BlockBits, typename Allocator>
+void fill(tiered_vector<T, BlockBits, Allocator>& tv, const T& value, thread_pool& pool = default_pool()){
+    pool.run(tv.segment_count(), [&](size_t b){
+        std::span<T> seg = tv.segment(b);
+        std::fill(seg.begin(), seg.end(), value);
+    });
+}
+
+// gen is called concurrently. If it takes a size_t it receives the element
+// index (tv[i] = gen(i)), which keeps generated values independent of the
+// schedule; a nullary gen must be safe to call from several threads.
+template <typename T, size_t BlockBits, typename Allocator, typename Generator>
+void generate(tiered_vector<T, BlockBits, Allocator>& tv, Generator gen, thread_pool& pool = default_pool()){
+    pool.run(tv.segment_count(), [&](size_t b){
+        std::span<T> seg = tv.segment(b);
+        size_t base = tv.segment_offset(b);
+        for(size_t i = 0; i < seg.size(); ++i){
+            if constexpr (std::is_invocable_v<Generator&, size_t>) seg[i] = gen(base + i);
+            else seg[i] = gen();
+        }
+    });
+}
+
+}
+
+namespace detail {
+
+// A sorted run of `len` elements starting at `first`; runs live either in the
+// container's blocks (the first merge round) or in a scratch buffer.
+template <typename T>
+struct sort_run{
+    T* first;
+    size_t len;
+};
+
+// Merge-path split: how many of the first d outputs of a stable merge of a and
+// b come from a. Ties go to a, so the merge stays stable.
+template <typename T, typename Compare>
+size_t merge_path(const T* a, size_t na, const T* b, size_t nb, size_t d, Compare& comp){
+    size_t lo = d > nb ? d - nb : 0;
+    size_t hi = std::min(d, na);
+    while(lo < hi){
+        size_t mid = (lo + hi) / 2;
+        if(comp(b[d - mid - 1], a[mid])) hi = mid;
+        else lo = mid + 1;
+    }
+    return lo;
+}
+
+// Merges the sorted runs pairwise, round by round, ping-ponging between two
+// scratch buffers. Every pair is cut into output chunks with merge_path, so a
+// round is one batch of independent, similar sized tasks on raw pointers.
+// Returns the buffer holding the single sorted run.
+template <typename T, typename Compare>
+T* merge_runs(std::vector<sort_run<T>> runs, size_t n, T* buf_a, T* buf_b, Compare& comp, parallel::thread_pool& pool){
+    struct merge_task{
+        sort_run<T> a, b;
+        size_t d_first, d_last;
+        T* out;
+    };
+
+    const size_t chunk = std::max<size_t>(size_t(1) << 14, n / (pool.size() * 8));
+    T* dst = buf_a;
+    T* other = buf_b;
+
+    while(runs.size() > 1){
+        std::vector<sort_run<T>> next;
+        std::vector<merge_task> tasks;
+        size_t base = 0;
+        for(size_t r = 0; r < runs.size(); r += 2){
+            sort_run<T> a = runs[r];
+            sort_run<T> b = r + 1 < runs.size() ? runs[r + 1] : sort_run<T>{nullptr, 0};
+            size_t len = a.len + b.len;
+            for(size_t d = 0; d < len; d += chunk){
+                tasks.push_back({a, b, d, std::min(len, d + chunk), dst + base});
+            }
+            next.push_back({dst + base, len});
+            base += len;
+        }
+
+        pool.run(tasks.size(), [&](size_t t){
+            const merge_task& m = tasks[t];
+            size_t i0 = merge_path<T>(m.a.first, m.a.len, m.b.first, m.b.len, m.d_first, comp);
+            size_t i1 = merge_path<T>(m.a.first, m.a.len, m.b.first, m.b.len, m.d_last, comp);
+            T* a = m.a.first + i0;
+            T* a_last = m.a.first + i1;
+            T* b = m.b.first + (m.d_first - i0);
+            T* b_last = m.b.first + (m.d_last - i1);
+            T* out = m.out + m.d_first;
+            T* out_last = m.out + m.d_last;
+            // Merges from both ends at once: the smallest remaining element goes
+            // to the front, the largest to the back. The two steps don't depend
+            // on each other, so the CPU overlaps them, and each picks its side
+            // with a conditional move rather than a branch that random data
+            // mispredicts half the time. Ties go to a at the front and to b at
+            // the back, which keeps the merge stable.
+            while(a != a_last && b != b_last){
+                bool take_b = comp(*b, *a);
+                *out++ = move(take_b ? *b : *a);
+                b += take_b;
+                a += !take_b;
+                if(a == a_last || b == b_last) break;
+
+                bool take_a = comp(b_last[-1], a_last[-1]);
+                *--out_last = move(take_a ? a_last[-1] : b_last[-1]);
+                a_last -= take_a;
+                b_last -= !take_a;
+            }
+            out = std::move(a, a_last, out);
+            std::move(b, b_last, out);
+        });
+
+        runs = move(next);
+        std::swap(dst, other);
+    }
+    return runs[0].first;
+}
+
+// Moves the contiguous sorted result back into the container's blocks.
+template <typename T, size_t BlockBits, typename Allocator>
+void move_back(tiered_vector<T, BlockBits, Allocator>& tv, T* sorted, parallel::thread_pool& pool){
+    pool.run(tv.segment_count(), [&](size_t b){
+        std::span<T> seg = tv.segment(b);
+        T* src = sorted + tv.segment_offset(b);
+        std::move(src, src + seg.size(), seg.begin());
+    });
+}
+
+template <typename T, size_t BlockBits, typename Allocator, typename Compare, typename BlockSort>
+void block_merge_sort(tiered_vector<T, BlockBits, Allocator>& tv, Compare& comp, parallel::thread_pool& pool, BlockSort block_sort){
+    pool.run(tv.segment_count(), [&](size_t b){
+        std::span<T> seg = tv.segment(b);
+        block_sort(seg.begin(), seg.end(), comp);
+    });
+    if(tv.segment_count() < 2) return;
+
+    std::vector<sort_run<T>> runs;
+    runs.reserve(tv.segment_count());
+    tv.for_each_segment([&](std::span<T> seg){ runs.push_back({seg.data(), seg.size()}); });
+
+    size_t n = tv.size();
+    auto buf_a = std::make_unique_for_overwrite<T[]>(n);
+    auto buf_b = std::make_unique_for_overwrite<T[]>(runs.size() > 2 ? n : 0);
+    move_back(tv, merge_runs(move(runs), n, buf_a.get(), buf_b.get(), comp, pool), pool);
+}
+
+// Integral keys with the default ordering go to radix_sort from this size on.
+inline constexpr size_t radix_sort_threshold = size_t(1) << 16;
+
+template <typename T, typename Compare>
+constexpr bool radix_sortable = is_integral_v<T> && !is_same_v<T, bool> &&
+    (is_same_v<Compare, std::less<T>> || is_same_v<Compare, std::less<>>);
+
+}
+
+// Ascending, stable LSD radix sort for integral T, one byte per pass. The
+// elements are moved into a scratch buffer, then each pass counts digits per
+// chunk in parallel, turns the counts into per-chunk output offsets and
+// scatters the chunks in parallel into the other buffer. A pass where every
+// element has the same digit is skipped. Signed keys are ordered by flipping
+// the sign bit of the top byte.
+template <typename T, size_t BlockBits, typename Allocator>
+void radix_sort(tiered_vector<T, BlockBits, Allocator>& tv, parallel::thread_pool& pool = parallel::default_pool()){
+    static_assert(is_integral_v<T> && !is_same_v<T, bool>, "radix_sort needs an integral key");
+    using U = std::make_unsigned_t<T>;
+    constexpr U sign_flip = is_signed_v<T> ? U(U(1) << (sizeof(T) * 8 - 1)) : U(0);
+
+    size_t n = tv.size();
+    if(n < 2) return;
+
+    auto buf_a = std::make_unique_for_overwrite<T[]>(n);
+    auto buf_b = std::make_unique_for_overwrite<T[]>(n);
+    T* src = buf_a.get();
+    T* dst = buf_b.get();
+
+    pool.run(tv.segment_count(), [&](size_t b){
+        std::span<T> seg = tv.segment(b);
+        std::copy(seg.begin(), seg.end(), src + tv.segment_offset(b));
+    });
+
+    const size_t chunks = std::min(n, pool.size() * 4);
+    std::vector<std::array<size_t, 256>> counts(chunks);
+    auto chunk_first = [&](size_t c){return n * c / chunks;};
+
+    for(size_t shift = 0; shift < sizeof(T) * 8; shift += 8){
+        auto digit = [&](T x){return size_t(((U(x) ^ sign_flip) >> shift) & 0xFF);};
+
+        pool.run(chunks, [&](size_t c){
+            std::array<size_t, 256>& h = counts[c];
+            h.fill(0);
+            for(size_t i = chunk_first(c); i < chunk_first(c + 1); ++i) h[digit(src[i])]++;
+        });
+
+        // Offsets in (digit, chunk) order keep the scatter stable.
+        size_t pos = 0;
+        bool trivial = false;
+        for(size_t d = 0; d < 256; ++d){
+            size_t total = 0;
+            for(size_t c = 0; c < chunks; ++c){
+                size_t k = counts[c][d];
+                counts[c][d] = pos;
+                pos += k;
+                total += k;
+            }
+            if(total == n) trivial = true;
+        }
+        if(trivial) continue;
+
+        pool.run(chunks, [&](size_t c){
+            std::array<size_t, 256>& out = counts[c];
+            for(size_t i = chunk_first(c); i < chunk_first(c + 1); ++i) dst[out[digit(src[i])]++] = src[i];
+        });
+        std::swap(src, dst);
+    }
+
+    detail::move_back(tv, src, pool);
+}
+
+// Sorts tv in parallel, in two phases:
+//   1. every block is sorted in place on raw pointers, one task per block;
+//   2. the sorted blocks are merged pairwise, round by round, through two
+//      scratch buffers of size() elements. Each pair is split with merge-path
+//      into equal output chunks, so the merge rounds are parallel as well.
+// The result is then moved back into the blocks. Elements therefore move
+// between blocks, which std::sort on the iterators cannot avoid either, but
+// no block is reallocated. Integral keys with the default ordering take the
+// radix_sort path instead once the container holds radix_sort_threshold
+// elements. comp is called from several threads at once. T must be default
+// constructible for the scratch buffers. If comp throws, the exception is
+// rethrown once the running tasks finish, with the basic guarantee only: tv
+// keeps its size and holds valid objects, but the merge moves elements into
+// the scratch buffers, so some may be moved-from and others missing. The
+// values are unspecified, not merely reordered.
+template <typename T, size_t BlockBits, typename Allocator, typename Compare = std::less<>>
+void sort(tiered_vector<T, BlockBits, Allocator>& tv, Compare comp = {}, parallel::thread_pool& pool = parallel::default_pool()){
+    if constexpr (detail::radix_sortable<T, Compare>){
+        if(tv.size() >= detail::radix_sort_threshold){
+            radix_sort(tv, pool);
+            return;
+        }
+    }
+    detail::block_merge_sort(tv, comp, pool, [](auto first, auto last, Compare& c){ std::sort(first, last, c); });
+}
+
+// Like sort(), but equal elements keep their order: blocks are sorted with
+// std::stable_sort and the merge takes from the earlier run on ties. The
+// radix path is stable too.
+template <typename T, size_t BlockBits, typename Allocator, typename Compare = std::less<>>
+void stable_sort(tiered_vector<T, BlockBits, Allocator>& tv, Compare comp = {}, parallel::thread_pool& pool = parallel::default_pool()){
+    if constexpr (detail::radix_sortable<T, Compare>){
+        if(tv.size() >= detail::radix_sort_threshold){
+            radix_sort(tv, pool);
+            return;
+        }
+    }
+    detail::block_merge_sort(tv, comp, pool, [](auto first, auto last, Compare& c){ std::stable_sort(first, last, c); });
+}
+
+}
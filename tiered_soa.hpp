@@ -0,0 +1,356 @@
+#pragma once
+#include "tiered_vector.hpp"
+
+namespace cppx {
+
+// Block size for a set of columns: every column must hold the same number of
+// elements per block, so take the smallest default, keeping the widest
+// column's blocks near 16 KB.
+template <typename... Ts>
+constexpr size_t soa_block_bits(){
+    return std::min({default_block_bits<Ts>()...});
+}
+
+// Columnar (structure-of-arrays) tiered container: one block array per field,
+// all sharing one spine geometry. Row idx of column C lives at
+// column_block<C>(idx>>BlockBits)[idx&block_mask], so a scan of one field
+// streams only that field's blocks through the cache, instead of dragging whole
+// records the way tiered_vector<Struct> does.
+//
+// Rows are added with push_back(tuple) or emplace_back(one argument per
+// column). get<C>(idx) and segment<C>(b) / for_each_segment<C>(f) access one
+// column; operator[] and the zip iterator yield a std::tuple of references to
+// every field of a row, which works with structured bindings.
+//
+// Allocator is rebound to each column type for the blocks and to the block
+// pointer tuple for the spine. Like tiered_vector's block cache, one emptied
+// block set is kept as a spare, so a size that oscillates around a block
+// boundary does not allocate and free on every call.
+template <size_t BlockBits, typename Allocator, typename... Ts>
+class basic_tiered_soa{
+    static_assert(BlockBits > 0 && BlockBits < 32, "BlockBits must be in [1, 31]");
+    static_assert(sizeof...(Ts) > 0, "tiered_soa needs at least one column");
+
+    public:
+        static constexpr size_t block_bits = BlockBits;
+        static constexpr size_t block_size = size_t(1) << BlockBits;
+        static constexpr size_t block_mask = block_size - 1;
+        static constexpr size_t column_count = sizeof...(Ts);
+
+        template <size_t C>
+        using column_type = std::tuple_element_t<C, std::tuple<Ts...>>;
+
+        using value_type = std::tuple<Ts...>;
+        using reference = std::tuple<Ts&...>;
+        using const_reference = std::tuple<const Ts&...>;
+        using allocator_type = Allocator;
+
+    private:
+        using block_set = std::tuple<Ts*...>;
+        using indices = std::index_sequence_for<Ts...>;
+
+        using alloc_traits    = std::allocator_traits<Allocator>;
+        using spine_allocator = typename alloc_traits::template rebind_alloc<block_set>;
+
+        template <size_t C>
+        using column_allocator = typename alloc_traits::template rebind_alloc<column_type<C>>;
+        template <size_t C>
+        using column_traits = std::allocator_traits<column_allocator<C>>;
+
+        std::vector<block_set, spine_allocator> spine;
+        size_t sz;
+        // An emptied block set kept for the next block; all null when there is none.
+        block_set spare;
+        [[no_unique_address]] Allocator alloc;
+
+        template <size_t C>
+        column_type<C>* allocate_column(){
+            column_allocator<C> a(alloc);
+            return column_traits<C>::allocate(a, block_size);
+        }
+
+        template <size_t C>
+        void deallocate_column(column_type<C>* p){
+            column_allocator<C> a(alloc);
+            column_traits<C>::deallocate(a, p, block_size);
+        }
+
+        template <size_t... I>
+        block_set allocate_blocks(std::index_sequence<I...>){
+            block_set blocks{};
+            try{
+                ((std::get<I>(blocks) = allocate_column<I>()), ...);
+            }
+            catch(...){
+                deallocate_blocks(blocks, indices{});
+                throw;
+            }
+            return blocks;
+        }
+
+        template <size_t... I>
+        void deallocate_blocks(block_set& blocks, std::index_sequence<I...>){
+            ((std::get<I>(blocks) != nullptr ? deallocate_column<I>(std::get<I>(blocks)) : void()), ...);
+            blocks = block_set{};
+        }
+
+        bool has_spare() const {return std::get<0>(spare) != nullptr;}
+
+        block_set acquire_blocks(){
+            if(!has_spare()) return allocate_blocks(indices{});
+            return std::exchange(spare, block_set{});
+        }
+
+        void release_blocks(block_set& blocks){
+            if(has_spare()) deallocate_blocks(blocks, indices{});
+            else spare = std::exchange(blocks, block_set{});
+        }
+
+        template <size_t C>
+        void destroy_at(column_type<C>* p){
+            column_allocator<C> a(alloc);
+            column_traits<C>::destroy(a, p);
+        }
+
+        template <size_t... I>
+        void destroy_row(size_t idx, std::index_sequence<I...>){
+            (destroy_at<I>(std::get<I>(spine[idx>>BlockBits]) + (idx&block_mask)), ...);
+        }
+
+        // Constructs column I of row idx from each argument. If a later column
+        // throws, the ones already built are destroyed.
+        template <size_t I = 0, typename Arg, typename... Rest>
+        void construct_row(size_t idx, Arg&& arg, Rest&&... rest){
+            column_type<I>* slot = std::get<I>(spine[idx>>BlockBits]) + (idx&block_mask);
+            column_allocator<I> a(alloc);
+            column_traits<I>::construct(a, slot, std::forward<Arg>(arg));
+            if constexpr (sizeof...(Rest) > 0){
+                try{
+                    construct_row<I + 1>(idx, std::forward<Rest>(rest)...);
+                }
+                catch(...){
+                    destroy_at<I>(slot);
+                    throw;
+                }
+            }
+        }
+
+        template <typename Tuple, size_t... I>
+        void push_tuple(Tuple&& row, std::index_sequence<I...>){
+            emplace_back(std::get<I>(std::forward<Tuple>(row))...);
+        }
+
+        template <size_t... I>
+        reference row(size_t idx, std::index_sequence<I...>){
+            const block_set& blocks = spine[idx>>BlockBits];
+            return reference(std::get<I>(blocks)[idx&block_mask]...);
+        }
+
+        template <size_t... I>
+        const_reference row(size_t idx, std::index_sequence<I...>) const {
+            const block_set& blocks = spine[idx>>BlockBits];
+            return const_reference(std::get<I>(blocks)[idx&block_mask]...);
+        }
+
+    public:
+        // Zip iterator over rows. Dereferencing yields a tuple of references
+        // (a proxy, like vector<bool>), so it is not a std::random_access_iterator
+        // for C++20 algorithms, but supports the usual arithmetic and ordering.
+        template <bool is_const>
+        class ZipIterator{
+            public:
+                using iterator_category = std::random_access_iterator_tag;
+                using difference_type   = std::ptrdiff_t;
+                using value_type        = std::tuple<Ts...>;
+                using reference         = std::conditional_t<is_const, const_reference, basic_tiered_soa::reference>;
+                using pointer           = void;
+                using parent_type       = std::conditional_t<is_const, const basic_tiered_soa*, basic_tiered_soa*>;
+
+            private:
+                template <bool> friend class ZipIterator;
+
+                // Block pointers of the current block, reloaded from the spine
+                // only when idx crosses a block boundary.
+                parent_type parent;
+                size_t idx;
+                block_set blocks;
+
+                void load(){
+                    if((idx>>BlockBits) < parent->spine.size()) blocks = parent->spine[idx>>BlockBits];
+                }
+
+                template <size_t... I>
+                reference deref(std::index_sequence<I...>) const {
+                    return reference(std::get<I>(blocks)[idx&block_mask]...);
+                }
+
+            public:
+                ZipIterator() : parent(nullptr), idx(0), blocks{} {}
+                ZipIterator(parent_type v, size_t i) : parent(v), idx(i), blocks{} {load();}
+
+                template <bool other_const, typename = std::enable_if_t<is_const && !other_const>>
+                ZipIterator(const ZipIterator<other_const>& other) : parent(other.parent), idx(other.idx), blocks(other.blocks) {}
+
+                reference operator*() const {return deref(indices{});}
+
+                ZipIterator& operator++(){
+                    if((++idx&block_mask) == 0) load();
+                    return *this;
+                }
+                ZipIterator operator++(int){ZipIterator tmp = *this; ++(*this); return tmp;}
+                ZipIterator& operator--(){
+                    if((idx--&block_mask) == 0) load();
+                    return *this;
+                }
+                ZipIterator operator--(int){ZipIterator tmp = *this; --(*this); return tmp;}
+
+                ZipIterator& operator+=(difference_type incr){
+                    size_t next = idx + incr;
+                    bool same_block = (next>>BlockBits) == (idx>>BlockBits);
+                    idx = next;
+                    if(!same_block) load();
+                    return *this;
+                }
+                ZipIterator& operator-=(difference_type incr){return *this += -incr;}
+
+                friend ZipIterator operator+(ZipIterator it, difference_type incr){return it += incr;}
+                friend ZipIterator operator+(difference_type incr, ZipIterator it){return it += incr;}
+                friend ZipIterator operator-(ZipIterator it, difference_type incr){return it -= incr;}
+
+                friend difference_type operator-(const ZipIterator& a, const ZipIterator& b){return a.idx - b.idx;}
+
+                friend bool operator==(const ZipIterator& a, const ZipIterator& b){return a.idx == b.idx;}
+                friend bool operator!=(const ZipIterator& a, const ZipIterator& b){return a.idx != b.idx;}
+                friend bool operator<(const ZipIterator& a, const ZipIterator& b){return a.idx < b.idx;}
+                friend bool operator<=(const ZipIterator& a, const ZipIterator& b){return a.idx <= b.idx;}
+                friend bool operator>(const ZipIterator& a, const ZipIterator& b){return a.idx > b.idx;}
+                friend bool operator>=(const ZipIterator& a, const ZipIterator& b){return a.idx >= b.idx;}
+                reference operator[](difference_type incr) const {return *(*this + incr);}
+        };
+
+        using iterator = ZipIterator<false>;
+        using const_iterator = ZipIterator<true>;
+
+        basic_tiered_soa() : basic_tiered_soa(Allocator()) {}
+
+        explicit basic_tiered_soa(const Allocator& a) : spine(spine_allocator(a)), sz(0), spare{}, alloc(a) {}
+
+        basic_tiered_soa(const basic_tiered_soa&) = delete;
+        basic_tiered_soa& operator= (const basic_tiered_soa&) = delete;
+
+        basic_tiered_soa(basic_tiered_soa&& value) noexcept :
+            spine(move(value.spine)), sz(value.sz), spare(std::exchange(value.spare, block_set{})), alloc(value.alloc)
+        {
+            value.spine.clear();
+            value.sz = 0;
+        }
+
+        ~basic_tiered_soa(){
+            clear();
+            deallocate_blocks(spare, indices{});
+        }
+
+        allocator_type get_allocator() const {return alloc;}
+
+        // One argument per column.
+        template <typename... Args>
+        void emplace_back(Args&&... args){
+            static_assert(sizeof...(Args) == sizeof...(Ts), "emplace_back takes one argument per column");
+            if((sz>>BlockBits) == spine.size()){
+                // push_back grows the spine geometrically; the new blocks are
+                // released again if it throws.
+                block_set blocks = acquire_blocks();
+                try{
+                    spine.push_back(blocks);
+                }
+                catch(...){
+                    release_blocks(blocks);
+                    throw;
+                }
+            }
+            construct_row(sz, std::forward<Args>(args)...);
+            sz++;
+        }
+
+        void push_back(const value_type& row){
+            push_tuple(row, indices{});
+        }
+
+        void push_back(value_type&& row){
+            push_tuple(move(row), indices{});
+        }
+
+        // The last block is released once its last row is popped: kept as the
+        // spare if there is none yet, freed otherwise.
+        void pop_back(){
+            if(sz == 0) return;
+
+            destroy_row(--sz, indices{});
+            if((sz&block_mask) == 0){
+                release_blocks(spine.back());
+                spine.pop_back();
+            }
+        }
+
+        // Keeps one spare block set, like pop_back.
+        void clear(){
+            while(sz > 0) pop_back();
+            for(block_set& blocks : spine) release_blocks(blocks);
+            spine.clear();
+        }
+
+        void reserve(size_t n){
+            spine.reserve((n + block_mask) >> BlockBits);
+        }
+
+        reference operator[](size_t idx) {return row(idx, indices{});}
+        const_reference operator[](size_t idx) const {return row(idx, indices{});}
+
+        template <size_t C>
+        column_type<C>& get(size_t idx){
+            return std::get<C>(spine[idx>>BlockBits])[idx&block_mask];
+        }
+
+        template <size_t C>
+        const column_type<C>& get(size_t idx) const {
+            return std::get<C>(spine[idx>>BlockBits])[idx&block_mask];
+        }
+
+        // Column C of block b as a span over its live rows; b < segment_count().
+        template <size_t C>
+        std::span<column_type<C>> segment(size_t b){
+            return std::span<column_type<C>>(std::get<C>(spine[b]), std::min(block_size, sz - (b<<BlockBits)));
+        }
+
+        template <size_t C>
+        std::span<const column_type<C>> segment(size_t b) const {
+            return std::span<const column_type<C>>(std::get<C>(spine[b]), std::min(block_size, sz - (b<<BlockBits)));
+        }
+
+        size_t segment_count() const {return (sz + block_mask) >> BlockBits;}
+
+        // Calls f(std::span) for column C of every block, in order.
+        template <size_t C, typename F>
+        void for_each_segment(F&& f){
+            for(size_t b = 0; b < segment_count(); ++b) f(segment<C>(b));
+        }
+
+        template <size_t C, typename F>
+        void for_each_segment(F&& f) const {
+            for(size_t b = 0; b < segment_count(); ++b) f(segment<C>(b));
+        }
+
+        iterator begin() {return iterator(this, 0);}
+        iterator end() {return iterator(this, sz);}
+        const_iterator begin() const {return const_iterator(this, 0);}
+        const_iterator end() const {return const_iterator(this, sz);}
+
+        size_t size() const {return sz;}
+        size_t capacity() const {return spine.size()<<BlockBits;}
+        bool empty() const {return sz == 0;}
+};
+
+template <typename... Ts>
+using tiered_soa = basic_tiered_soa<soa_block_bits<Ts...>(), std::allocator<std::byte>, Ts...>;
+
+}
@@ -3,9 +3,366 @@
 using namespace std;
 
 namespace cppx {
+
+// Picks log2(elements per block) so that a block is ~16 KB: large enough to
+// amortize the spine hop during scans, small enough to keep the tail waste and
+// TLB footprint low. Never fewer than 16 or more than 64K elements per block.
+template <typename T>
+constexpr size_t default_block_bits(){
+    size_t bits = 4;
+    while(bits < 16 && (size_t(2) << bits) * sizeof(T) <= 16384) ++bits;
+    return bits;
+}
+
+struct block_cache_stats{
+    size_t hits;        // acquire() served from the free list
+    size_t misses;      // acquire() that had to go to the allocator
+    size_t recycled;    // blocks parked in the free list
+    size_t freed;       // blocks handed back to the allocator because the list was full
+    size_t cached;      // blocks currently parked
+    size_t peak_cached; // high-water mark of cached
+};
+
+// Hot-path counters of one tiered_vector. Only filled in when the program is
+// built with -DCPPX_TIERED_VECTOR_STATS; otherwise stats() returns zeros.
+struct tiered_vector_stats{
+    size_t block_allocs;       // blocks taken for the spine (from the cache or the allocator)
+    size_t block_frees;        // blocks given back (to the cache or the allocator)
+    size_t pop_back_trims;     // pop_back emptied the last block and recycled it
+    size_t spine_reallocs;     // spine moved to a new allocation
+    size_t spine_bytes_copied; // block pointers copied or slid by spine changes
+    size_t blocks;             // blocks currently held
+    size_t peak_blocks;        // high-water mark of blocks
+    size_t peak_bytes;         // peak_blocks in bytes
+};
+
+class tiered_vector_registry;
+
+namespace detail {
+
+// Stats policy used when instrumentation is off: every hook is an empty inline
+// function and the member takes no space, so the calls compile to nothing.
+struct null_tiered_counters{
+    explicit null_tiered_counters(const char*, size_t) {}
+    void block_acquired() {}
+    void block_released() {}
+    void pop_back_trim() {}
+    void spine_moved(size_t, bool) {}
+    void set_blocks(size_t) {}
+    tiered_vector_stats read() const {return tiered_vector_stats{};}
+};
+
+// Stats policy used with CPPX_TIERED_VECTOR_STATS. The owning container is the
+// only writer, so counters are bumped with relaxed load + store (plain moves,
+// no locked instructions); the atomics only let the registry read them from
+// another thread. Every instance links itself into the global registry for its
+// lifetime. Copies and moves start from zero and register separately.
+class tiered_counters{
+    friend class cppx::tiered_vector_registry;
+
+    static void bump(std::atomic<size_t>& c, size_t n = 1){
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    const char* type_name;
+    size_t block_bytes;
+    std::atomic<size_t> block_allocs{0}, block_frees{0}, pop_back_trims{0};
+    std::atomic<size_t> spine_reallocs{0}, spine_bytes_copied{0};
+    std::atomic<size_t> blocks{0}, peak_blocks{0};
+    tiered_counters* prev = nullptr;
+    tiered_counters* next = nullptr;
+
+    public:
+        inline tiered_counters(const char* name, size_t bytes_per_block);
+        tiered_counters(const tiered_counters& other) : tiered_counters(other.type_name, other.block_bytes) {}
+        tiered_counters& operator= (const tiered_counters&) {return *this;}
+        inline ~tiered_counters();
+
+        void block_acquired(){
+            bump(block_allocs);
+            set_blocks(blocks.load(std::memory_order_relaxed) + 1);
+        }
+
+        void block_released(){
+            bump(block_frees);
+            blocks.store(blocks.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        }
+
+        void pop_back_trim() {bump(pop_back_trims);}
+
+        // A spine change that copied `bytes` of block pointers; `fresh` if it
+        // needed a new allocation rather than a slide within the old one.
+        void spine_moved(size_t bytes, bool fresh){
+            if(fresh) bump(spine_reallocs);
+            bump(spine_bytes_copied, bytes);
+        }
+
+        // Blocks handed over wholesale (move, swap).
+        void set_blocks(size_t n){
+            blocks.store(n, std::memory_order_relaxed);
+            if(n > peak_blocks.load(std::memory_order_relaxed)) peak_blocks.store(n, std::memory_order_relaxed);
+        }
+
+        tiered_vector_stats read() const {
+            tiered_vector_stats s{};
+            s.block_allocs = block_allocs.load(std::memory_order_relaxed);
+            s.block_frees = block_frees.load(std::memory_order_relaxed);
+            s.pop_back_trims = pop_back_trims.load(std::memory_order_relaxed);
+            s.spine_reallocs = spine_reallocs.load(std::memory_order_relaxed);
+            s.spine_bytes_copied = spine_bytes_copied.load(std::memory_order_relaxed);
+            s.blocks = blocks.load(std::memory_order_relaxed);
+            s.peak_blocks = peak_blocks.load(std::memory_order_relaxed);
+            s.peak_bytes = s.peak_blocks * block_bytes;
+            return s;
+        }
+};
+
 template <typename T>
+const char* tiered_type_name(){
+#ifdef __cpp_rtti
+    return typeid(T).name();
+#else
+    return "tiered_vector";
+#endif
+}
+
+#ifdef CPPX_TIERED_VECTOR_STATS
+using tiered_counters_policy = tiered_counters;
+#else
+using tiered_counters_policy = null_tiered_counters;
+#endif
+
+}
+
+// Every instrumented tiered_vector alive in the process, plus the summed
+// counters of the ones already destroyed. Registration is an intrusive list
+// insert under a mutex, so constructing a container never allocates for it.
+// The macro changes tiered_vector's layout: define it for the whole program.
+class tiered_vector_registry{
+    friend class detail::tiered_counters;
+
+    public:
+        struct entry{
+            const char* type_name; // typeid(T).name()
+            tiered_vector_stats stats;
+        };
+
+    private:
+        mutable std::mutex mtx;
+        detail::tiered_counters* head = nullptr;
+        size_t live_count = 0;
+        tiered_vector_stats retired{};
+
+        static void add_to(tiered_vector_stats& total, const tiered_vector_stats& s){
+            total.block_allocs += s.block_allocs;
+            total.block_frees += s.block_frees;
+            total.pop_back_trims += s.pop_back_trims;
+            total.spine_reallocs += s.spine_reallocs;
+            total.spine_bytes_copied += s.spine_bytes_copied;
+            total.blocks += s.blocks;
+            total.peak_blocks += s.peak_blocks;
+            total.peak_bytes += s.peak_bytes;
+        }
+
+        void link(detail::tiered_counters* c){
+            std::lock_guard<std::mutex> lock(mtx);
+            c->next = head;
+            if(head != nullptr) head->prev = c;
+            head = c;
+            live_count++;
+        }
+
+        void unlink(detail::tiered_counters* c){
+            std::lock_guard<std::mutex> lock(mtx);
+            if(c->prev != nullptr) c->prev->next = c->next;
+            else head = c->next;
+            if(c->next != nullptr) c->next->prev = c->prev;
+            live_count--;
+
+            tiered_vector_stats s = c->read();
+            s.blocks = 0;
+            add_to(retired, s);
+        }
+
+    public:
+        static tiered_vector_registry& instance(){
+            static tiered_vector_registry registry;
+            return registry;
+        }
+
+        std::vector<entry> live() const {
+            std::lock_guard<std::mutex> lock(mtx);
+            std::vector<entry> out;
+            out.reserve(live_count);
+            for(const detail::tiered_counters* c = head; c != nullptr; c = c->next) out.push_back({c->type_name, c->read()});
+            return out;
+        }
+
+        // Live and destroyed containers together. peak_blocks and peak_bytes
+        // are the sum of each container's own peak.
+        tiered_vector_stats totals() const {
+            std::lock_guard<std::mutex> lock(mtx);
+            tiered_vector_stats total = retired;
+            for(const detail::tiered_counters* c = head; c != nullptr; c = c->next) add_to(total, c->read());
+            return total;
+        }
+
+        // One line per live container, then the totals.
+        void dump(std::ostream& os) const {
+            auto row = [&os](const string& name, const tiered_vector_stats& s){
+                os << left << setw(24) << name.substr(0, 23)
+                   << setw(10) << s.blocks << setw(12) << s.peak_blocks
+                   << setw(12) << fixed << setprecision(1) << s.peak_bytes / (1024.0 * 1024.0)
+                   << setw(12) << s.block_allocs << setw(12) << s.block_frees
+                   << setw(12) << s.pop_back_trims << setw(12) << s.spine_reallocs
+                   << s.spine_bytes_copied << '\n';
+            };
+
+            std::vector<entry> entries = live();
+            os << "tiered_vector stats: " << entries.size() << " live containers\n";
+            os << left << setw(24) << "type" << setw(10) << "blocks" << setw(12) << "peak_blk"
+               << setw(12) << "peak_MB" << setw(12) << "allocs" << setw(12) << "frees"
+               << setw(12) << "pop_trims" << setw(12) << "spine_re" << "spine_bytes" << '\n';
+            for(const entry& e : entries) row(e.type_name, e.stats);
+            row("(all, incl. destroyed)", totals());
+        }
+};
+
+detail::tiered_counters::tiered_counters(const char* name, size_t bytes_per_block) : type_name(name), block_bytes(bytes_per_block){
+    tiered_vector_registry::instance().link(this);
+}
+
+detail::tiered_counters::~tiered_counters(){
+    tiered_vector_registry::instance().unlink(this);
+}
+
+// Free list of raw, unconstructed blocks. Every tiered_vector lazily gets a
+// private one that keeps a single spare block (the old pop_back hysteresis);
+// a larger one can be shared between containers whose allocators compare equal.
+// acquire()/recycle() only run on block boundaries, so a mutex is cheap here
+// and makes sharing across threads safe; a container whose private cache was
+// never handed out uses the _unlocked versions instead. The free list is
+// reserved up to the limit, so recycle() never allocates and can run from
+// destructors and noexcept moves.
+template <typename T, size_t BlockBits = default_block_bits<T>(), typename Allocator = std::allocator<T>>
+class block_cache{
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    public:
+        using allocator_type = Allocator;
+        static constexpr size_t block_size = size_t(1) << BlockBits;
+
+    private:
+        mutable std::mutex mtx;
+        std::vector<T*> blocks;
+        size_t limit;
+        block_cache_stats counters{};
+        [[no_unique_address]] Allocator alloc;
+
+        void trim_locked(size_t keep){
+            while(blocks.size() > keep){
+                alloc_traits::deallocate(alloc, blocks.back(), block_size);
+                blocks.pop_back();
+                counters.freed++;
+            }
+            counters.cached = blocks.size();
+        }
+
+    public:
+        explicit block_cache(size_t max_blocks = 1, const Allocator& a = Allocator()) : limit(max_blocks), alloc(a) {
+            blocks.reserve(limit);
+        }
+
+        block_cache(const block_cache&) = delete;
+        block_cache& operator= (const block_cache&) = delete;
+
+        ~block_cache(){
+            for(T* block : blocks){
+                alloc_traits::deallocate(alloc, block, block_size);
+            }
+        }
+
+        T* acquire(){
+            std::lock_guard<std::mutex> lock(mtx);
+            return acquire_unlocked();
+        }
+
+        void recycle(T* block) noexcept {
+            std::lock_guard<std::mutex> lock(mtx);
+            recycle_unlocked(block);
+        }
+
+        // For a caller that knows no other thread can reach this cache.
+        T* acquire_unlocked(){
+            if(blocks.empty()){
+                counters.misses++;
+                return alloc_traits::allocate(alloc, block_size);
+            }
+            T* block = blocks.back();
+            blocks.pop_back();
+            counters.hits++;
+            counters.cached = blocks.size();
+            return block;
+        }
+
+        void recycle_unlocked(T* block) noexcept {
+            if(blocks.size() >= limit){
+                alloc_traits::deallocate(alloc, block, block_size);
+                counters.freed++;
+                return;
+            }
+            blocks.push_back(block);
+            counters.recycled++;
+            counters.cached = blocks.size();
+            counters.peak_cached = std::max(counters.peak_cached, counters.cached);
+        }
+
+        // Returns cached blocks to the allocator until at most `keep` remain.
+        void trim(size_t keep = 0){
+            std::lock_guard<std::mutex> lock(mtx);
+            trim_locked(keep);
+        }
+
+        void set_max_blocks(size_t max_blocks){
+            std::lock_guard<std::mutex> lock(mtx);
+            blocks.reserve(max_blocks);
+            limit = max_blocks;
+            trim_locked(limit);
+        }
+
+        size_t max_blocks() const {
+            std::lock_guard<std::mutex> lock(mtx);
+            return limit;
+        }
+
+        size_t cached_bytes() const {
+            std::lock_guard<std::mutex> lock(mtx);
+            return blocks.size() * block_size * sizeof(T);
+        }
+
+        block_cache_stats stats() const {
+            std::lock_guard<std::mutex> lock(mtx);
+            return counters;
+        }
+
+        void reset_stats(){
+            std::lock_guard<std::mutex> lock(mtx);
+            counters = block_cache_stats{};
+            counters.cached = counters.peak_cached = blocks.size();
+        }
+
+        allocator_type get_allocator() const {return alloc;}
+};
+
+template <typename T, size_t BlockBits = default_block_bits<T>(), typename Allocator = std::allocator<T>>
 class tiered_vector{
+    static_assert(BlockBits > 0 && BlockBits < 32, "BlockBits must be in [1, 31]");
+
     public:
+        static constexpr size_t block_bits = BlockBits;
+        static constexpr size_t block_size = size_t(1) << BlockBits;
+        static constexpr size_t block_mask = block_size - 1;
+
         template <bool is_const>
         class TieredVectorIterator{
             public:
@@ -19,256 +376,879 @@ class tiered_vector{
                 using const_reverse_iterator = std::reverse_iterator<const TieredVectorIterator>;
 
             private:
+                template <bool> friend class TieredVectorIterator;
+
+                // Cursor into the current block, like a deque iterator: stepping
+                // within a block is a pointer bump and the spine is only read when
+                // cur runs into last. A missing block (end() on a block boundary)
+                // is represented by cur == last == nullptr. Equality only compares
+                // cur, which keeps the loop test of a scan a single compare.
+                // Blocks and positions are physical, i.e. include the front offset.
                 parent_type parent;
-                size_t idx;
+                pointer cur;
+                pointer last;
+                size_t block;
+
+                void load(size_t b){
+                    block = b;
+                    if(b < parent->block_sz){
+                        cur = parent->pdata[b];
+                        last = cur + block_size;
+                    }
+                    else{
+                        cur = last = nullptr;
+                    }
+                }
+
+                void seek(size_t p){
+                    load(p>>BlockBits);
+                    if(cur != nullptr) cur += (p&block_mask);
+                }
+
+                size_t position() const {
+                    return (block<<BlockBits) + (cur != nullptr ? size_t(cur - (last - block_size)) : 0);
+                }
+
+                size_t index() const {return position() - parent->off;}
 
             public:
-                TieredVectorIterator(parent_type v, size_t i) : parent(v), idx(i) {}
+                TieredVectorIterator() : parent(nullptr), cur(nullptr), last(nullptr), block(0) {}
+                TieredVectorIterator(parent_type v, size_t i) : parent(v) {seek(i + v->off);}
+
+                template <bool other_const, typename = std::enable_if_t<is_const && !other_const>>
+                TieredVectorIterator(const TieredVectorIterator<other_const>& other) :
+                    parent(other.parent), cur(other.cur), last(other.last), block(other.block) {}
 
-                reference operator*() const {return (*parent)[idx];}
-                pointer operator->() const {return &(*parent)[idx];}
+                reference operator*() const {return *cur;}
+                pointer operator->() const {return cur;}
 
-                TieredVectorIterator& operator++(){++idx; return *this;}
+                TieredVectorIterator& operator++(){
+                    if(++cur == last) load(block + 1);
+                    return *this;
+                }
                 TieredVectorIterator operator++(int){TieredVectorIterator tmp = *this; ++(*this); return tmp;}
-                TieredVectorIterator& operator--(){--idx; return *this;}
+                TieredVectorIterator& operator--(){
+                    if(cur == nullptr || cur == last - block_size){
+                        load(block - 1);
+                        cur = last;
+                    }
+                    --cur;
+                    return *this;
+                }
                 TieredVectorIterator operator--(int){TieredVectorIterator tmp = *this; --(*this); return tmp;}
 
-                TieredVectorIterator& operator+=(difference_type incr){idx += incr; return *this;}
-                TieredVectorIterator& operator-=(difference_type incr){idx -= incr; return *this;}
+                TieredVectorIterator& operator+=(difference_type incr){
+                    size_t next = position() + incr;
+                    if(cur != nullptr && (next>>BlockBits) == block) cur += incr;
+                    else seek(next);
+                    return *this;
+                }
+                TieredVectorIterator& operator-=(difference_type incr){return *this += -incr;}
 
-                friend TieredVectorIterator operator+(TieredVectorIterator it, difference_type incr){return TieredVectorIterator(it.parent, it.idx + incr);}
-                friend TieredVectorIterator operator+(difference_type incr, TieredVectorIterator it){return TieredVectorIterator(it.parent, it.idx + incr);}
-                friend TieredVectorIterator operator-(TieredVectorIterator it, difference_type incr){return TieredVectorIterator(it.parent, it.idx - incr);}
-                friend TieredVectorIterator operator-(difference_type incr, TieredVectorIterator it){return TieredVectorIterator(it.parent, it.idx - incr);}
+                friend TieredVectorIterator operator+(TieredVectorIterator it, difference_type incr){return it += incr;}
+                friend TieredVectorIterator operator+(difference_type incr, TieredVectorIterator it){return it += incr;}
+                friend TieredVectorIterator operator-(TieredVectorIterator it, difference_type incr){return it -= incr;}
+                friend TieredVectorIterator operator-(difference_type incr, TieredVectorIterator it){return it -= incr;}
 
-                friend difference_type operator-(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.idx - b.idx;}
-                friend difference_type operator+(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.idx + b.idx;}
+                friend difference_type operator-(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.index() - b.index();}
+                friend difference_type operator+(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.index() + b.index();}
                 
-                friend bool operator==(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.idx == b.idx;}
-                friend bool operator!=(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.idx != b.idx;}
-                friend bool operator<(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.idx < b.idx;}
-                friend bool operator<=(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.idx <= b.idx;}
-                friend bool operator>(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.idx > b.idx;}
-                friend bool operator>=(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.idx >= b.idx;}
+                friend bool operator==(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.cur == b.cur;}
+                friend bool operator!=(const TieredVectorIterator& a, const TieredVectorIterator& b){return !(a == b);}
+                friend bool operator<(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.index() < b.index();}
+                friend bool operator<=(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.index() <= b.index();}
+                friend bool operator>(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.index() > b.index();}
+                friend bool operator>=(const TieredVectorIterator& a, const TieredVectorIterator& b){return a.index() >= b.index();}
                 reference operator[](difference_type incr) const {return *(*this + incr);};
 
-                
+                // Calls f(std::span) once per block overlapped by [first, last).
+                template <typename F>
+                static void for_each_segment(TieredVectorIterator first, TieredVectorIterator last, F&& f){
+                    size_t i = first.position();
+                    size_t n = last.position();
+                    while(i < n){
+                        size_t seg_end = std::min(n, (i | block_mask) + 1);
+                        f(std::span<value_ref>(first.parent->pdata[i>>BlockBits] + (i&block_mask), seg_end - i));
+                        i = seg_end;
+                    }
+                }
+
+                // Segment-wise versions of the common algorithms. They are hidden
+                // friends, so an unqualified call (copy(tv.begin(), tv.end(), out))
+                // picks them over the std:: templates through ADL and runs over
+                // contiguous spans the compiler can vectorize.
+                template <typename OutputIt>
+                friend OutputIt copy(TieredVectorIterator first, TieredVectorIterator last, OutputIt out){
+                    for_each_segment(first, last, [&out](auto seg){ out = std::copy(seg.begin(), seg.end(), out); });
+                    return out;
+                }
+
+                friend void fill(TieredVectorIterator first, TieredVectorIterator last, const T& value){
+                    for_each_segment(first, last, [&value](auto seg){ std::fill(seg.begin(), seg.end(), value); });
+                }
+
+                template <typename U>
+                friend TieredVectorIterator find(TieredVectorIterator first, TieredVectorIterator last, const U& value){
+                    return find_segmented(first, last, value);
+                }
+
+                template <typename Init>
+                friend Init accumulate(TieredVectorIterator first, TieredVectorIterator last, Init init){
+                    for_each_segment(first, last, [&init](auto seg){ init = std::accumulate(seg.begin(), seg.end(), move(init)); });
+                    return init;
+                }
+
+                template <typename Init, typename BinaryOp>
+                friend Init accumulate(TieredVectorIterator first, TieredVectorIterator last, Init init, BinaryOp op){
+                    for_each_segment(first, last, [&init, &op](auto seg){ init = std::accumulate(seg.begin(), seg.end(), move(init), op); });
+                    return init;
+                }
+
+            private:
+                using value_ref = std::conditional_t<is_const, const T, T>;
+
+                template <typename U>
+                static TieredVectorIterator find_segmented(TieredVectorIterator first, TieredVectorIterator last, const U& value){
+                    size_t i = first.position();
+                    size_t n = last.position();
+                    while(i < n){
+                        size_t seg_end = std::min(n, (i | block_mask) + 1);
+                        pointer seg = first.parent->pdata[i>>BlockBits] + (i&block_mask);
+                        pointer hit = std::find(seg, seg + (seg_end - i), value);
+                        if(hit != seg + (seg_end - i)) return TieredVectorIterator(first.parent, i + (hit - seg) - first.parent->off);
+                        i = seg_end;
+                    }
+                    return last;
+                }
         };
+
+        // Forward range over the blocks, yielding each one as a std::span trimmed
+        // to the live elements (only the last block is ever partial).
+        template <bool is_const>
+        class SegmentRange{
+            public:
+                using element_type = std::conditional_t<is_const, const T, T>;
+                using value_type   = std::span<element_type>;
+                using parent_type  = std::conditional_t<is_const, const tiered_vector*, tiered_vector*>;
+
+                class iterator{
+                    public:
+                        using iterator_category = std::forward_iterator_tag;
+                        using difference_type   = std::ptrdiff_t;
+                        using value_type        = std::span<element_type>;
+                        using reference         = value_type;
+                        using pointer           = void;
+
+                    private:
+                        parent_type parent;
+                        size_t block;
+
+                    public:
+                        iterator() : parent(nullptr), block(0) {}
+                        iterator(parent_type v, size_t b) : parent(v), block(b) {}
+
+                        value_type operator*() const {return parent->segment(block);}
+
+                        iterator& operator++(){++block; return *this;}
+                        iterator operator++(int){iterator tmp = *this; ++block; return tmp;}
+
+                        friend bool operator==(const iterator& a, const iterator& b){return a.block == b.block;}
+                        friend bool operator!=(const iterator& a, const iterator& b){return a.block != b.block;}
+                };
+
+            private:
+                parent_type parent;
+
+            public:
+                explicit SegmentRange(parent_type v) : parent(v) {}
+
+                iterator begin() const {return iterator(parent, 0);}
+                iterator end() const {return iterator(parent, parent->segment_count());}
+                size_t size() const {return parent->segment_count();}
+                bool empty() const {return parent->sz == 0;}
+        };
+
     private:
+        using alloc_traits    = std::allocator_traits<Allocator>;
+        using spine_allocator = typename alloc_traits::template rebind_alloc<T*>;
+        using spine_traits    = std::allocator_traits<spine_allocator>;
+
+        static_assert(is_same_v<typename alloc_traits::value_type, T>, "Allocator::value_type must be T");
+        static_assert(is_same_v<typename alloc_traits::pointer, T*>, "fancy pointers are not supported");
+
+        // pdata points spine_head slots into a spine of block_cap slots, so
+        // push_front can prepend blocks without moving the spine. Element i lives
+        // at physical position off + i, where off < block_size is the number of
+        // unused slots at the start of the first block.
         T** pdata;
         T* internal_pdata[8];
+        size_t spine_head;
         size_t block_sz;
         size_t block_cap;
+        size_t off;
         size_t sz;
+        [[no_unique_address]] Allocator alloc;
+        std::shared_ptr<block_cache<T, BlockBits, Allocator>> cache;
+        // True while cache was created here and never handed out, so no other
+        // container can be recycling through it.
+        bool cache_owned;
+        [[no_unique_address]] detail::tiered_counters_policy stats_counters;
 
-        void reallocate(size_t new_cap){
-            T** new_data = new T*[new_cap]();
+        T** allocate_spine(size_t n){
+            spine_allocator spine_alloc(alloc);
+            T** spine = spine_traits::allocate(spine_alloc, n);
+            std::fill_n(spine, n, nullptr);
+            return spine;
+        }
+
+        T** spine_base() const {return pdata - spine_head;}
 
-            for(size_t i = 0; i<block_sz; ++i){
-                new_data[i] = move(pdata[i]);
+        void deallocate_spine(){
+            T** base = spine_base();
+            if(base != internal_pdata && base != nullptr){
+                spine_allocator spine_alloc(alloc);
+                spine_traits::deallocate(spine_alloc, base, block_cap);
             }
-            if(pdata != internal_pdata && pdata != nullptr)
-                delete[] pdata;
-            pdata = new_data;
+        }
+
+        // Moves the block pointers to slot new_head of a spine with new_cap
+        // slots. Keeping the capacity just slides them within the current spine.
+        void reallocate(size_t new_cap, size_t new_head = 0){
+            T** base = spine_base();
+            if(new_cap == block_cap && base != nullptr){
+                std::memmove(base + new_head, pdata, block_sz * sizeof(T*));
+                stats_counters.spine_moved(block_sz * sizeof(T*), false);
+                std::fill(base, base + new_head, nullptr);
+                std::fill(base + new_head + block_sz, base + block_cap, nullptr);
+                pdata = base + new_head;
+                spine_head = new_head;
+                return;
+            }
+
+            T** new_data;
+            if(block_cap == 0 && new_cap <= 8){
+                new_cap = 8;
+                new_data = internal_pdata;
+                std::fill_n(new_data, 8, nullptr);
+            }
+            else{
+                new_data = allocate_spine(new_cap);
+                for(size_t i = 0; i<block_sz; ++i){
+                    new_data[new_head + i] = move(pdata[i]);
+                }
+                deallocate_spine();
+                stats_counters.spine_moved(block_sz * sizeof(T*), true);
+            }
+            pdata = new_data + new_head;
+            spine_head = new_head;
             block_cap = new_cap;
         }
 
-        void allocate(){
+        // Room for needed_blocks blocks from pdata on. Once push_front has used
+        // the head of the spine, free slots are split between both ends.
+        void grow_spine(size_t needed_blocks){
+            if(needed_blocks <= block_cap - spine_head) return;
+
+            if(spine_head > 0 && needed_blocks <= block_cap / 2){
+                reallocate(block_cap, (block_cap - needed_blocks) / 2);
+                return;
+            }
+
+            size_t new_cap = block_cap == 0 ? 8 : block_cap;
+            while(new_cap < needed_blocks) new_cap <<= 1;
+
+            reallocate(new_cap, spine_head > 0 ? (new_cap - needed_blocks) / 2 : 0);
+        }
+
+        // Makes sure there is a free slot in front of pdata[0].
+        void grow_spine_front(){
+            if(spine_head > 0) return;
+
+            size_t needed_blocks = block_sz + 1;
+            size_t new_cap = block_cap == 0 ? 8 : block_cap;
+            while(new_cap < 2 * needed_blocks) new_cap <<= 1;
+
+            reallocate(new_cap, (new_cap - block_sz + 1) / 2);
+        }
+
+        // Blocks are raw storage obtained from the allocator. Elements are
+        // constructed in place when they come into existence and destroyed when
+        // they leave, so T needs neither a default constructor nor a copy constructor.
+        T* allocate_block(){
+            return alloc_traits::allocate(alloc, block_size);
+        }
+
+        void deallocate_block(T* block){
+            alloc_traits::deallocate(alloc, block, block_size);
+        }
+
+        T* acquire_block(){
+            T* block = !cache ? allocate_block() : cache_owned ? cache->acquire_unlocked() : cache->acquire();
+            stats_counters.block_acquired();
+            return block;
+        }
+
+        void make_cache(){
+            if(cache) return;
+            cache = std::make_shared<block_cache<T, BlockBits, Allocator>>(1, alloc);
+            cache_owned = true;
+        }
+
+        void recycle_block(T* block){
+            make_cache();
+            recycle_to_cache(block);
+            stats_counters.block_released();
+        }
+
+        // A private cache nobody else can reach skips the lock.
+        void recycle_to_cache(T* block) noexcept {
+            if(cache_owned) cache->recycle_unlocked(block);
+            else cache->recycle(block);
+        }
+
+        // Hands blocks past the first `needed` back to the cache.
+        void trim_blocks(size_t needed){
+            while(block_sz > needed){
+                recycle_block(pdata[--block_sz]);
+                pdata[block_sz] = nullptr;
+            }
+        }
+
+        template <typename... Args>
+        T* construct_element(size_t idx, Args&&... args){
+            size_t p = off + idx;
+            T* slot = pdata[p>>BlockBits] + (p&block_mask);
+            alloc_traits::construct(alloc, slot, std::forward<Args>(args)...);
+            return slot;
+        }
+
+        void destroy_range(size_t first, size_t last){
+            if constexpr (!is_trivially_destructible_v<T>){
+                first += off;
+                last += off;
+                while(first < last){
+                    size_t block_end = std::min(last, (first | block_mask) + 1);
+                    T* block = pdata[first>>BlockBits];
+                    for(T* p = block + (first&block_mask); p != block + (block_end - (first & ~block_mask)); ++p){
+                        alloc_traits::destroy(alloc, p);
+                    }
+                    first = block_end;
+                }
+            }
+        }
+
+        // Destroys every element and returns all memory to the allocator.
+        void release(){
+            destroy_range(0, sz);
+            for(size_t i = 0; i < block_sz; ++i){
+                if(cache) recycle_to_cache(pdata[i]);
+                else deallocate_block(pdata[i]);
+                stats_counters.block_released();
+            }
+            deallocate_spine();
+            pdata = nullptr;
+            spine_head = 0;
+            block_sz = 0;
+            block_cap = 0;
+            off = 0;
+            sz = 0;
+        }
+
+        // Takes over value's storage; *this must be empty. Allocators must compare equal.
+        void steal(tiered_vector& value) noexcept {
+            pdata = value.pdata;
+            spine_head = value.spine_head;
+            block_sz = value.block_sz;
+            block_cap = value.block_cap;
+            off = value.off;
+            sz = value.sz;
+
+            if(value.spine_base() == value.internal_pdata){
+                pdata = internal_pdata + spine_head;
+                for(size_t i=0; i<8; ++i) internal_pdata[i] = value.internal_pdata[i];
+            }
+            value.pdata = nullptr;
+            value.spine_head = 0;
+            value.block_sz = 0;
+            value.block_cap = 0;
+            value.off = 0;
+            value.sz = 0;
+            stats_counters.set_blocks(block_sz);
+            value.stats_counters.set_blocks(0);
+        }
+
+        // Destroys the elements but keeps the blocks for the next fill.
+        void clear_elements(){
+            destroy_range(0, sz);
+            sz = 0;
+            off = 0;
+        }
+
+        void swap_storage(tiered_vector& other){
+            // An SBO spine has to move with its contents; a heap spine is just a pointer.
+            bool mine_internal = spine_base() == internal_pdata;
+            bool theirs_internal = other.spine_base() == other.internal_pdata;
+            T** mine = pdata;
+            T** theirs = other.pdata;
+
+            for (size_t i = 0; i < 8; ++i) {
+                std::swap(internal_pdata[i], other.internal_pdata[i]);
+            }
+            pdata = theirs_internal ? internal_pdata + other.spine_head : theirs;
+            other.pdata = mine_internal ? other.internal_pdata + spine_head : mine;
 
+            std::swap(spine_head, other.spine_head);
+            std::swap(sz, other.sz);
+            std::swap(off, other.off);
+            std::swap(block_sz, other.block_sz);
+            std::swap(block_cap, other.block_cap);
+            stats_counters.set_blocks(block_sz);
+            other.stats_counters.set_blocks(other.block_sz);
         }
 
         void insertBlock(){
             reallocate(block_cap << 1);
         }
 
-        void initNextSubArray(){
-            if(block_cap == 0){
-                pdata = internal_pdata;
-                block_cap = 8;
+        template <typename Construct>
+        void resize_with(size_t new_size, Construct construct){
+            if(new_size <= sz){
+                destroy_range(new_size, sz);
+                sz = new_size;
+                trim_blocks((off + sz + block_mask) >> BlockBits);
+                return;
             }
-            else if(block_sz == block_cap){
-                reallocate(block_cap<<1);
+
+            ensure_blocks(new_size);
+
+            for(; sz < new_size; ++sz){
+                size_t p = off + sz;
+                construct(pdata[p>>BlockBits] + (p&block_mask));
             }
+        }
 
-            pdata[block_sz++] = new T[1024]();
+        void initNextSubArray(){
+            grow_spine(block_sz + 1);
+            pdata[block_sz++] = acquire_block();
+        }
+
+        // Elements can be copied with memcpy when T is trivially copyable and the
+        // allocator's construct() would only do a placement copy anyway.
+        static constexpr bool bitwise_copyable = is_trivially_copyable_v<T> &&
+            (!requires(Allocator& a, T* p, const T& v){ a.construct(p, v); } ||
+             (is_same_v<Allocator, std::pmr::polymorphic_allocator<T>> && !uses_allocator_v<T, Allocator>));
+
+        // Makes sure blocks exist for the first `n` elements, spine first.
+        void ensure_blocks(size_t n){
+            size_t needed = (off + n + block_mask) >> BlockBits;
+            grow_spine(needed);
+            for(; block_sz<needed; ++block_sz){
+                pdata[block_sz] = acquire_block();
+            }
+        }
+
+        // Appends n elements read from first, one whole block-chunk at a time.
+        template <typename ForwardIt>
+        void append_n(ForwardIt first, size_t n){
+            size_t new_size = sz + n;
+            ensure_blocks(new_size);
+
+            while(sz < new_size){
+                size_t p = off + sz;
+                size_t chunk = std::min(new_size - sz, block_size - (p&block_mask));
+                T* dst = pdata[p>>BlockBits] + (p&block_mask);
+
+                if constexpr (bitwise_copyable && std::contiguous_iterator<ForwardIt> &&
+                              is_same_v<remove_cv_t<std::iter_value_t<ForwardIt>>, T>){
+                    std::memcpy(static_cast<void*>(dst), std::to_address(first), chunk * sizeof(T));
+                    first += chunk;
+                    sz += chunk;
+                }
+                else{
+                    for(size_t k = 0; k < chunk; ++k, ++first){
+                        alloc_traits::construct(alloc, dst + k, *first);
+                        sz++;
+                    }
+                }
+            }
         }
 
     public:
 
+        using allocator_type = Allocator;
         using iterator = TieredVectorIterator<false>;
         using const_iterator = TieredVectorIterator<true>;
         using reverse_iterator = std::reverse_iterator<iterator>;
         using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-        tiered_vector() : pdata(nullptr), block_sz(0), block_cap(0), sz(0) {}
+        tiered_vector() : tiered_vector(Allocator()) {}
+
+        explicit tiered_vector(const Allocator& a) noexcept :
+            pdata(nullptr), internal_pdata{}, spine_head(0), block_sz(0), block_cap(0), off(0), sz(0), alloc(a), cache_owned(false),
+            stats_counters(detail::tiered_type_name<T>(), block_size * sizeof(T)) {}
 
         ~tiered_vector(){
-            for(size_t i = 0; i < block_sz; ++i){
-                delete[] pdata[i];
-            }
-            if(pdata != internal_pdata && pdata != nullptr)
-                delete [] pdata;
+            release();
         }
 
-        tiered_vector(initializer_list<T> value) : tiered_vector(){
-            reserve(value.size());
-            for(auto & item : value){
-                push_back(item);
-            }
+        tiered_vector(initializer_list<T> value, const Allocator& a = Allocator()) : tiered_vector(a){
+            append_n(value.begin(), value.size());
         }
 
-        tiered_vector(const tiered_vector& value){
-            sz = value.sz;
-            block_sz = value.block_sz;
-            block_cap = value.block_cap;
+        template <std::input_iterator InputIt>
+        tiered_vector(InputIt first, InputIt last, const Allocator& a = Allocator()) : tiered_vector(a){
+            append(first, last);
+        }
 
-            if(block_cap == 0){
-                pdata = nullptr;
-                return;
-            }
+        tiered_vector(const T* data, size_t n, const Allocator& a = Allocator()) : tiered_vector(a){
+            append_n(data, n);
+        }
 
-            if(value.pdata == value.internal_pdata){
-                pdata = internal_pdata;
-            }
-            else{
-                pdata = new T*[block_cap]();
-            }
+        tiered_vector(const tiered_vector& value) :
+            tiered_vector(value, alloc_traits::select_on_container_copy_construction(value.alloc)) {}
 
-            for(size_t i = 0; i<block_sz; ++i){
-                pdata[i] = new T[1024];
-                copy(value.pdata[i], value.pdata[i] + 1024, pdata[i]);
+        tiered_vector(const tiered_vector& value, const Allocator& a) : tiered_vector(a){
+            reserve(value.sz);
+            value.for_each_segment([this](std::span<const T> seg){ append_n(seg.data(), seg.size()); });
+        }
+
+        tiered_vector(tiered_vector && value) noexcept : tiered_vector(value.alloc){
+            cache = move(value.cache);
+            cache_owned = std::exchange(value.cache_owned, false);
+            steal(value);
+        }
+
+        tiered_vector(tiered_vector && value, const Allocator& a) : tiered_vector(a){
+            if(alloc == value.alloc){
+                steal(value);
+                return;
+            }
+            reserve(value.sz);
+            for(size_t i = 0; i < value.sz; ++i){
+                emplace_back(move(value[i]));
             }
         }
 
         void swap(tiered_vector& other){
-            if(pdata != internal_pdata && other.pdata != other.internal_pdata){
-                std::swap(pdata, other.pdata);
+            if constexpr (alloc_traits::propagate_on_container_swap::value){
+                std::swap(alloc, other.alloc);
+                std::swap(cache, other.cache);
+                std::swap(cache_owned, other.cache_owned);
             }
-            else if(pdata == internal_pdata && other.pdata == other.internal_pdata){
-                for (size_t i = 0; i < 8; ++i) {
-                    std::swap(internal_pdata[i], other.internal_pdata[i]);
+            swap_storage(other);
+        }
+
+        tiered_vector& operator= (const tiered_vector& value){
+            if(this == &value) return *this;
+
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value){
+                if(alloc != value.alloc){
+                    release();
+                    cache.reset();
+                    cache_owned = false;
                 }
+                alloc = value.alloc;
             }
-            else if(pdata != internal_pdata && other.pdata == other.internal_pdata){
-                other.pdata = pdata; 
-                
-                for(size_t i = 0; i<8; ++i){
-                    internal_pdata[i] = other.internal_pdata[i];
+            tiered_vector tmp(value, alloc);
+            swap_storage(tmp);
+            return *this;
+        }
+
+        tiered_vector& operator= (tiered_vector && value) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                                                   alloc_traits::is_always_equal::value){
+            if(this == &value) return *this;
+
+            if constexpr (alloc_traits::propagate_on_container_move_assignment::value){
+                release();
+                if(alloc != value.alloc){
+                    cache.reset();
+                    cache_owned = false;
                 }
-                pdata = internal_pdata;
+                alloc = value.alloc;
+                steal(value);
+            }
+            else if(alloc == value.alloc){
+                release();
+                steal(value);
             }
             else{
-                pdata = other.pdata;
-                
-                for(size_t i = 0; i<8; ++i){
-                    other.internal_pdata[i] = internal_pdata[i];
-                }
-                other.pdata = other.internal_pdata;
+                tiered_vector tmp(move(value), alloc);
+                swap_storage(tmp);
             }
+            return *this;
+        }
 
-            std::swap(sz, other.sz);
-            std::swap(block_sz, other.block_sz);
-            std::swap(block_cap, other.block_cap);
+        allocator_type get_allocator() const {return alloc;}
+
+        using block_cache_type = block_cache<T, BlockBits, Allocator>;
+
+        // The cache blocks are recycled through. Created on first use with room
+        // for one spare block unless one was installed with set_block_cache().
+        // Once handed out it may be shared, so shrink_to_fit() and
+        // memory_usage() stop treating it as this container's own.
+        std::shared_ptr<block_cache_type> get_block_cache(){
+            make_cache();
+            cache_owned = false;
+            return cache;
         }
 
-        tiered_vector& operator= (tiered_vector value){
-            this-> swap(value);
-            return *this;
+        // Shares `shared` with other containers; its allocator must compare equal to ours.
+        void set_block_cache(std::shared_ptr<block_cache_type> shared){
+            assert(!shared || shared->get_allocator() == alloc);
+            cache = move(shared);
+            cache_owned = false;
         }
 
-        tiered_vector(tiered_vector && value) noexcept :
-            pdata(value.pdata),
-            block_sz(value.block_sz),
-            block_cap(value.block_cap),
-            sz(value.sz)
-        {
-            if(value.pdata == value.internal_pdata){
-                pdata = internal_pdata;
-                for(size_t i=0; i<block_sz; ++i) internal_pdata[i] = value.internal_pdata[i];
-            }
-            value.pdata = nullptr;
-            value.block_sz = 0;
-            value.block_cap = 0;
-            value.sz = 0;
+        void set_block_cache_limit(size_t max_blocks){
+            make_cache();
+            cache->set_max_blocks(max_blocks);
         }
 
-        void push_back(const T& value){
-            if((sz&1023) == 0){
+        block_cache_stats cache_stats() const {
+            return cache ? cache->stats() : block_cache_stats{};
+        }
+
+        // This container's counters; all zero unless built with CPPX_TIERED_VECTOR_STATS.
+        tiered_vector_stats stats() const {
+            return stats_counters.read();
+        }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args){
+            if(((off + sz)&block_mask) == 0 && ((off + sz)>>BlockBits) == block_sz){
                 initNextSubArray();
             }
-            pdata[sz>>10][sz&1023] = value;
+            T* slot = construct_element(sz, std::forward<Args>(args)...);
             sz++;
+            return *slot;
+        }
+
+        void push_back(const T& value){
+            emplace_back(value);
         }
 
         void push_back(T&& value){
-            if((sz&1023) == 0){
-                initNextSubArray();
+            emplace_back(move(value));
+        }
+
+        // Bulk loads. Blocks for the whole range are allocated up front, then
+        // filled a block at a time (memcpy for trivially copyable T from
+        // contiguous sources). Single-pass input ranges fall back to emplace_back.
+        template <std::input_iterator InputIt>
+        void append(InputIt first, InputIt last){
+            if constexpr (std::forward_iterator<InputIt>){
+                append_n(first, static_cast<size_t>(std::distance(first, last)));
+            }
+            else{
+                for(; first != last; ++first) emplace_back(*first);
             }
-            pdata[sz>>10][sz&1023] = move(value);
-            sz++;
+        }
+
+        void append(const T* data, size_t n){
+            append_n(data, n);
+        }
+
+        void append(initializer_list<T> values){
+            append_n(values.begin(), values.size());
+        }
+
+        template <std::input_iterator InputIt>
+        void assign(InputIt first, InputIt last){
+            clear_elements();
+            append(first, last);
+        }
+
+        void assign(const T* data, size_t n){
+            clear_elements();
+            append_n(data, n);
+        }
+
+        void assign(size_t n, const T& value){
+            clear_elements();
+            resize(n, value);
+        }
+
+        void assign(initializer_list<T> values){
+            clear_elements();
+            append_n(values.begin(), values.size());
         }
 
         void pop_back(){
             if(sz == 0) return;
 
             sz--;
-            pdata[sz>>10][sz&1023].~T();
+            size_t p = off + sz;
+            alloc_traits::destroy(alloc, pdata[p>>BlockBits] + (p&block_mask));
 
-            size_t needed_blocks = (sz == 0) ? 0 : (sz>>10)+1;
+            if((p&block_mask) == 0){
+                stats_counters.pop_back_trim();
+                trim_blocks(p>>BlockBits);
+            }
+        }
 
-            if(block_sz > needed_blocks+1){
-                delete[] pdata[--block_sz];
-                pdata[block_sz] = nullptr;
+        // Front growth fills the first block from its end, and prepends a new
+        // block (into free spine slots before pdata) once it is full, so no
+        // element moves. Like std::deque, it invalidates iterators but not
+        // references.
+        template <typename... Args>
+        T& emplace_front(Args&&... args){
+            if(off == 0){
+                grow_spine_front();
+                T* block = acquire_block();
+                try{
+                    alloc_traits::construct(alloc, block + block_mask, std::forward<Args>(args)...);
+                }
+                catch(...){
+                    recycle_block(block);
+                    throw;
+                }
+                *--pdata = block;
+                spine_head--;
+                block_sz++;
+                off = block_mask;
+                sz++;
+                return *(block + block_mask);
             }
+            alloc_traits::construct(alloc, pdata[0] + off - 1, std::forward<Args>(args)...);
+            off--;
+            sz++;
+            return pdata[0][off];
         }
 
-        void reserve(size_t n){
-            if(n <= capacity()) return;
+        void push_front(const T& value){
+            emplace_front(value);
+        }
 
-            size_t needed_blocks = (n + 1023) >> 10;
+        void push_front(T&& value){
+            emplace_front(move(value));
+        }
 
-            size_t new_cap = block_cap == 0 ? 8 : block_cap;
-            while(new_cap < needed_blocks) new_cap <<= 1;
+        // The first block goes back to the cache once its last element is popped.
+        void pop_front(){
+            if(sz == 0) return;
 
-            reallocate(new_cap);
+            alloc_traits::destroy(alloc, pdata[0] + off);
+            sz--;
+            if(++off == block_size){
+                recycle_block(pdata[0]);
+                *pdata++ = nullptr;
+                spine_head++;
+                block_sz--;
+                off = 0;
+            }
         }
 
-        void resize(size_t new_size){
-            if(new_size == sz) return;
+        void clear(){
+            clear_elements();
+            trim_blocks(0);
+        }
 
-            if(new_size < sz){
-                for(size_t i = new_size; i<sz; ++i){
-                    pdata[i>>10][i&1023].~T();
-                }
-                sz = new_size;
-                return;
-            }
+        void reserve(size_t n){
+            if(n <= capacity()) return;
 
-            size_t needed = (new_size+1023) >> 10;
-            if(needed > block_cap){
-                size_t new_cap = block_cap == 0 ? 8 : block_cap;
+            grow_spine((off + n + block_mask) >> BlockBits);
+        }
 
-                while(new_cap < needed) new_cap <<= 1;
+        // Frees the blocks past the last element straight to the allocator, and
+        // empties the block cache if this container created it and never handed
+        // it out (see get_block_cache()).
+        // A heap spine is then cut down to the smallest power of two (at least 8)
+        // that fits the blocks, or moved back into internal_pdata when 8 slots
+        // are enough. Invalidates iterators but not references.
+        void shrink_to_fit(){
+            size_t needed = segment_count();
+            while(block_sz > needed){
+                deallocate_block(pdata[--block_sz]);
+                pdata[block_sz] = nullptr;
+                stats_counters.block_released();
+            }
+            if(cache_owned) cache->trim(0);
 
-                reallocate(new_cap);
+            if(block_sz == 0){
+                release();
+                return;
             }
+            if(spine_base() == internal_pdata) return;
 
-            for(size_t i = block_sz; i<needed; ++i){
-                pdata[i] = new T[1024]();
+            size_t new_cap = std::max<size_t>(8, std::bit_ceil(block_sz));
+            if(new_cap == 8){
+                std::fill_n(internal_pdata, 8, nullptr);
+                std::copy_n(pdata, block_sz, internal_pdata);
+                deallocate_spine();
+                stats_counters.spine_moved(block_sz * sizeof(T*), true);
+                pdata = internal_pdata;
+                spine_head = 0;
+                block_cap = 8;
+            }
+            else if(new_cap < block_cap){
+                reallocate(new_cap);
             }
+        }
 
-            block_sz = needed;
-            sz = new_size;
+        void resize(size_t new_size){
+            resize_with(new_size, [this](T* slot){ alloc_traits::construct(alloc, slot); });
+        }
+
+        void resize(size_t new_size, const T& value){
+            resize_with(new_size, [this, &value](T* slot){ alloc_traits::construct(alloc, slot, value); });
+        }
+
+        // Like resize(), but new elements are default-initialized, so for trivial
+        // T the blocks are left as allocated, ready to be overwritten in bulk
+        // (e.g. by readv straight into segments()). Bypasses Allocator::construct.
+        void resize_for_overwrite(size_t new_size){
+            resize_with(new_size, [](T* slot){ ::new (static_cast<void*>(slot)) T; });
         }
 
         T& operator[](size_t idx){
-            return pdata[idx>>10][idx&1023];
+            size_t p = off + idx;
+            return pdata[p>>BlockBits][p&block_mask];
         }
 
         const T& operator[](size_t idx) const {
-            return pdata[idx>>10][idx&1023];
+            size_t p = off + idx;
+            return pdata[p>>BlockBits][p&block_mask];
+        }
+
+        using segment_range = SegmentRange<false>;
+        using const_segment_range = SegmentRange<true>;
+
+        segment_range segments() {return segment_range(this);}
+        const_segment_range segments() const {return const_segment_range(this);}
+
+        // Block b as a span over its live elements; b < segment_count(). Only
+        // the first (after push_front) and the last block can be partial.
+        std::span<T> segment(size_t b){
+            size_t first = b == 0 ? off : 0;
+            return std::span<T>(pdata[b] + first, std::min(block_size, off + sz - (b<<BlockBits)) - first);
+        }
+
+        std::span<const T> segment(size_t b) const {
+            size_t first = b == 0 ? off : 0;
+            return std::span<const T>(pdata[b] + first, std::min(block_size, off + sz - (b<<BlockBits)) - first);
+        }
+
+        size_t segment_count() const {return sz == 0 ? 0 : (off + sz + block_mask) >> BlockBits;}
+
+        // Index of the first element of segment(b).
+        size_t segment_offset(size_t b) const {return b == 0 ? 0 : (b<<BlockBits) - off;}
+
+        // Calls f(std::span<T>) for every block in order, trimmed to the live elements.
+        template <typename F>
+        void for_each_segment(F&& f){
+            for(size_t b = 0; b < segment_count(); ++b) f(segment(b));
         }
 
+        template <typename F>
+        void for_each_segment(F&& f) const {
+            for(size_t b = 0; b < segment_count(); ++b) f(segment(b));
+        }
+
+        T& front() {return (*this)[0];}
+        const T& front() const {return (*this)[0];}
+        T& back() {return (*this)[sz - 1];}
+        const T& back() const {return (*this)[sz - 1];}
+
         iterator begin() {return iterator(this, 0);}
         iterator end() {return iterator(this, sz);}
         reverse_iterator rbegin() {return reverse_iterator(end());}
@@ -280,7 +1260,30 @@ class tiered_vector{
         const_reverse_iterator rend() const {return const_reverse_iterator(begin());}
 
         size_t size() const {return this->sz;}
-        size_t capacity() const {return this->block_cap<<10;}
+        size_t capacity() const {return ((this->block_cap - this->spine_head)<<BlockBits) - this->off;}
         bool empty() const {return ((this->sz) == 0);}
+
+        // Blocks currently held by the spine, including empty ones kept for refill.
+        size_t allocated_blocks() const {return block_sz;}
+
+        // Slots in the spine; the first 8 live inside the object itself.
+        size_t spine_capacity() const {return block_cap;}
+
+        // Heap bytes held: the blocks, the spine once it has left internal_pdata,
+        // and blocks parked in the block cache when it is this container's own
+        // (see shrink_to_fit()).
+        size_t memory_usage() const {
+            size_t bytes = block_sz * block_size * sizeof(T);
+            if(pdata != nullptr && spine_base() != internal_pdata) bytes += block_cap * sizeof(T*);
+            if(cache_owned) bytes += cache->cached_bytes();
+            return bytes;
+        }
 };
+
+namespace pmr {
+    // Blocks and spine come from a std::pmr::memory_resource, e.g. a
+    // monotonic_buffer_resource arena that is released in one step.
+    template <typename T, size_t BlockBits = default_block_bits<T>()>
+    using tiered_vector = cppx::tiered_vector<T, BlockBits, std::pmr::polymorphic_allocator<T>>;
+}
 }
\ No newline at end of file